@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h> // For exit and EXIT_FAILURE
 #include <pthread.h>
+#include "memory_manager.h"
 // ANSI color codes
 #define ANSI_COLOR_RED "\x1b[31m"
 #define ANSI_COLOR_GREEN "\x1b[32m"
@@ -41,6 +42,16 @@
 
 // #define my_assert(condition, test_name) my_assert_impl(condition, test_name, __FILE__, __LINE__, #condition)
 
+// The pool from mem_init(pool_size) is empty again when one block can take
+// all of it, so any leaked block fails the check. Calls the library
+// functions directly, also when MM_INLINE_FASTPATH is defined
+static inline int pool_is_empty(size_t pool_size)
+{
+    void *all = (mem_alloc)(pool_size - sizeof(struct mm_block_header));
+    (mem_free)(all);
+    return all != NULL;
+}
+
 typedef struct
 {
     pthread_mutex_t mutex;
@@ -0,0 +1,2 @@
+const char *git_date = "";
+const char *git_sha = "";
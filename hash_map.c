@@ -0,0 +1,244 @@
+#include "hash_map.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+/*
+ * Linjär hashning med låsränder:
+ * - hinken för en nyckel avgörs av nbuckets = 2^L + split: hinkar under
+ *   split är redan delade och adresseras med L+1 bitar
+ * - när tabellen blir för full delas en hink i taget, så ingen operation
+ *   behöver flytta om hela tabellen
+ * - antalet hinkar per nivå är en multipel av HM_STRIPES, så en hink och
+ *   dess delningspartner har alltid samma lås och låset följer av hashen
+ * - bara när hinkarrayen måste växa (mem_resize) tas alla lås
+ */
+#define HM_STRIPES 16   // tvåpotens
+#define HM_LOAD    2    // poster per hink innan nästa hink delas
+
+typedef struct HmEntry {
+    uint32_t        key;
+    uint32_t        hash;
+    void           *value;
+    struct HmEntry *next;
+} HmEntry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    char            pad[64 - sizeof(pthread_mutex_t) % 64];
+} HmStripe;
+
+struct HashMap {
+    HmStripe        stripes[HM_STRIPES];
+    pthread_mutex_t grow_lock;   // en delning i taget
+    HmEntry       **buckets;
+    size_t          capacity;    // allokerade hinkar
+    atomic_size_t   nbuckets;    // aktiva hinkar
+    atomic_size_t   count;
+};
+
+// murmur3:s slutmixning, så även låga bitar beror på hela nyckeln
+static uint32_t hm_hash(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85ebca6bu;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35u;
+    key ^= key >> 16;
+    return key;
+}
+
+// Största tvåpotens <= n
+static size_t level_size(size_t n) {
+    size_t level = 1;
+    while (level <= n / 2)
+        level <<= 1;
+    return level;
+}
+
+static size_t bucket_index(size_t nbuckets, uint32_t hash) {
+    size_t level = level_size(nbuckets);
+    size_t index = hash & (level - 1);
+    if (index < nbuckets - level)           // redan delad
+        index = hash & (2 * level - 1);
+    return index;
+}
+
+static pthread_mutex_t *stripe_for(HashMap *map, uint32_t hash) {
+    return &map->stripes[hash & (HM_STRIPES - 1)].lock;
+}
+
+// Hinken för hash (låsranden för hash måste vara tagen)
+static HmEntry **bucket_for(HashMap *map, uint32_t hash) {
+    return &map->buckets[bucket_index(atomic_load(&map->nbuckets), hash)];
+}
+
+HashMap *hash_map_create(size_t initial_buckets) {
+    HashMap *map = mem_alloc(sizeof(HashMap));
+    if (!map) return NULL;
+
+    size_t nbuckets = HM_STRIPES;
+    while (nbuckets < initial_buckets)
+        nbuckets <<= 1;
+
+    map->buckets = mem_alloc(nbuckets * sizeof(HmEntry *));
+    if (!map->buckets) {
+        mem_free(map);
+        return NULL;
+    }
+    memset(map->buckets, 0, nbuckets * sizeof(HmEntry *));
+    map->capacity = nbuckets;
+    atomic_init(&map->nbuckets, nbuckets);
+    atomic_init(&map->count, 0);
+
+    for (int i = 0; i < HM_STRIPES; i++)
+        pthread_mutex_init(&map->stripes[i].lock, NULL);
+    pthread_mutex_init(&map->grow_lock, NULL);
+    return map;
+}
+
+void hash_map_destroy(HashMap *map) {
+    if (!map) return;
+    size_t nbuckets = atomic_load(&map->nbuckets);
+    for (size_t i = 0; i < nbuckets; i++) {
+        HmEntry *e = map->buckets[i];
+        while (e) {
+            HmEntry *next = e->next;
+            mem_free(e);
+            e = next;
+        }
+    }
+    for (int i = 0; i < HM_STRIPES; i++)
+        pthread_mutex_destroy(&map->stripes[i].lock);
+    pthread_mutex_destroy(&map->grow_lock);
+    mem_free(map->buckets);
+    mem_free(map);
+}
+
+// Dubblar hinkarrayen med mem_resize (grow_lock måste vara tagen)
+static int grow_array(HashMap *map) {
+    for (int i = 0; i < HM_STRIPES; i++)
+        pthread_mutex_lock(&map->stripes[i].lock);
+
+    int ok = 0;
+    HmEntry **grown = mem_resize(map->buckets, 2 * map->capacity * sizeof(HmEntry *));
+    if (grown) {
+        memset(grown + map->capacity, 0, map->capacity * sizeof(HmEntry *));
+        map->buckets  = grown;
+        map->capacity *= 2;
+        ok = 1;
+    }
+
+    for (int i = HM_STRIPES - 1; i >= 0; i--)
+        pthread_mutex_unlock(&map->stripes[i].lock);
+    return ok;
+}
+
+// Delar nästa hink om tabellen är för full
+static void maybe_split(HashMap *map) {
+    if (atomic_load(&map->count) <= atomic_load(&map->nbuckets) * HM_LOAD)
+        return;
+    if (pthread_mutex_trylock(&map->grow_lock) != 0)
+        return;   // någon annan delar redan
+
+    size_t nbuckets = atomic_load(&map->nbuckets);
+    if (atomic_load(&map->count) > nbuckets * HM_LOAD &&
+        (nbuckets < map->capacity || grow_array(map))) {
+        size_t level = level_size(nbuckets);
+        size_t split = nbuckets - level;
+        pthread_mutex_t *stripe = &map->stripes[split & (HM_STRIPES - 1)].lock;
+
+        pthread_mutex_lock(stripe);
+        HmEntry **from = &map->buckets[split];
+        HmEntry **to   = &map->buckets[split + level];
+        while (*from) {
+            HmEntry *e = *from;
+            if ((e->hash & (2 * level - 1)) != split) {
+                *from   = e->next;
+                e->next = *to;
+                *to     = e;
+            } else {
+                from = &e->next;
+            }
+        }
+        atomic_store(&map->nbuckets, nbuckets + 1);
+        pthread_mutex_unlock(stripe);
+    }
+    pthread_mutex_unlock(&map->grow_lock);
+}
+
+int hash_map_put(HashMap *map, uint32_t key, void *value) {
+    uint32_t hash = hm_hash(key);
+    pthread_mutex_t *stripe = stripe_for(map, hash);
+
+    pthread_mutex_lock(stripe);
+    HmEntry **bucket = bucket_for(map, hash);
+    for (HmEntry *e = *bucket; e; e = e->next) {
+        if (e->key == key) {
+            e->value = value;
+            pthread_mutex_unlock(stripe);
+            return 0;
+        }
+    }
+
+    HmEntry *e = mem_alloc(sizeof(HmEntry));
+    if (!e) {
+        pthread_mutex_unlock(stripe);
+        return -1;
+    }
+    e->key   = key;
+    e->hash  = hash;
+    e->value = value;
+    e->next  = *bucket;
+    *bucket  = e;
+    atomic_fetch_add(&map->count, 1);
+    pthread_mutex_unlock(stripe);
+
+    maybe_split(map);
+    return 0;
+}
+
+int hash_map_get(HashMap *map, uint32_t key, void **value) {
+    uint32_t hash = hm_hash(key);
+    pthread_mutex_t *stripe = stripe_for(map, hash);
+
+    pthread_mutex_lock(stripe);
+    for (HmEntry *e = *bucket_for(map, hash); e; e = e->next) {
+        if (e->key == key) {
+            if (value) *value = e->value;
+            pthread_mutex_unlock(stripe);
+            return 1;
+        }
+    }
+    pthread_mutex_unlock(stripe);
+    return 0;
+}
+
+int hash_map_remove(HashMap *map, uint32_t key) {
+    uint32_t hash = hm_hash(key);
+    pthread_mutex_t *stripe = stripe_for(map, hash);
+
+    pthread_mutex_lock(stripe);
+    HmEntry **link = bucket_for(map, hash);
+    while (*link && (*link)->key != key)
+        link = &(*link)->next;
+
+    HmEntry *e = *link;
+    if (e) {
+        *link = e->next;
+        atomic_fetch_sub(&map->count, 1);
+    }
+    pthread_mutex_unlock(stripe);
+
+    if (!e) return 0;
+    mem_free(e);
+    return 1;
+}
+
+size_t hash_map_size(HashMap *map) {
+    return atomic_load(&map->count);
+}
+
+size_t hash_map_buckets(HashMap *map) {
+    return atomic_load(&map->nbuckets);
+}
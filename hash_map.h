@@ -0,0 +1,34 @@
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#include <stdint.h>   // för uint32_t
+#include <stddef.h>   // för size_t
+#include "memory_manager.h"
+
+// Trådsäker hashtabell med låsränder. Tabellen växer en hink i taget
+// (linjär hashning) och hinkarrayen utökas med mem_resize, så allt minne
+// kommer från samma pool som listorna (mem_init först)
+typedef struct HashMap HashMap;
+
+// Skapar en tabell med minst initial_buckets hinkar, NULL om minnet inte räcker
+HashMap* hash_map_create(size_t initial_buckets);
+
+// Frigör tabellen och alla poster
+void hash_map_destroy(HashMap* map);
+
+// Lägger in eller uppdaterar key. Returnerar 0, eller -1 om minnet tog slut
+int hash_map_put(HashMap* map, uint32_t key, void* value);
+
+// Hämtar värdet för key, returnerar 1 om den fanns
+int hash_map_get(HashMap* map, uint32_t key, void** value);
+
+// Tar bort key, returnerar 1 om den fanns
+int hash_map_remove(HashMap* map, uint32_t key);
+
+// Antal poster
+size_t hash_map_size(HashMap* map);
+
+// Antal aktiva hinkar (växer när tabellen fylls)
+size_t hash_map_buckets(HashMap* map);
+
+#endif
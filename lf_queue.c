@@ -0,0 +1,252 @@
+#include "lf_queue.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Michael-Scott-kö med hazard pointers:
+ * - head pekar på en dummy-nod, enqueue länkar in efter tail och
+ *   dequeue flyttar head, så ändarna arbetar oberoende av varandra
+ * - en tråd publicerar noderna den läser i sina hazard-slots; en nod
+ *   som tagits ur kön läggs i trådens retire-lista och lämnas till
+ *   mem_free först när ingen slot pekar på den
+ */
+#define LFQ_MAX_THREADS 512
+#define LFQ_HAZARDS     2
+#define LFQ_SCAN_AT     64   // retire-listans längd innan den gås igenom
+
+typedef struct LfqNode {
+    void                     *value;
+    _Atomic(struct LfqNode *) next;
+} LfqNode;
+
+struct LfQueue {
+    _Atomic(LfqNode *) head;
+    char               pad[64 - sizeof(void *)];   // head och tail på olika cacherader
+    _Atomic(LfqNode *) tail;
+};
+
+typedef struct {
+    LfqNode *node;
+    LfQueue *queue;   // så lf_queue_destroy hittar sina noder
+} Retired;
+
+typedef struct {
+    _Atomic(LfqNode *) hazard[LFQ_HAZARDS];
+    atomic_int         in_use;
+    pthread_mutex_t    retire_lock;   // tas av ägaren, och av lf_queue_destroy
+    Retired           *retired;
+    size_t             retired_count;
+    size_t             retired_cap;
+    char               pad[64];
+} HpRecord;
+
+static HpRecord       hp_records[LFQ_MAX_THREADS];
+static atomic_int     hp_used;   // högsta index som någon gång delats ut + 1
+static pthread_key_t  hp_key;
+static pthread_once_t hp_once = PTHREAD_ONCE_INIT;
+static __thread HpRecord *my_record;
+
+// Posten och dess retire-lista tas över av nästa tråd som behöver en
+static void hp_release(void *arg) {
+    HpRecord *rec = arg;
+    for (int i = 0; i < LFQ_HAZARDS; i++)
+        atomic_store(&rec->hazard[i], NULL);
+    atomic_store(&rec->in_use, 0);
+}
+
+static void hp_init(void) {
+    pthread_key_create(&hp_key, hp_release);
+    for (int i = 0; i < LFQ_MAX_THREADS; i++)
+        pthread_mutex_init(&hp_records[i].retire_lock, NULL);
+}
+
+static HpRecord *hp_record(void) {
+    if (my_record) return my_record;
+    pthread_once(&hp_once, hp_init);
+
+    for (int i = 0; i < LFQ_MAX_THREADS; i++) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&hp_records[i].in_use, &expected, 1)) {
+            int used = atomic_load(&hp_used);
+            while (used <= i && !atomic_compare_exchange_weak(&hp_used, &used, i + 1))
+                ;
+            my_record = &hp_records[i];
+            pthread_setspecific(hp_key, my_record);
+            return my_record;
+        }
+    }
+    return NULL;
+}
+
+static int ptr_cmp(const void *a, const void *b) {
+    uintptr_t x = *(const uintptr_t *)a;
+    uintptr_t y = *(const uintptr_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Frigör de noder i retire-listan som ingen hazard pointer skyddar
+static void hp_scan(HpRecord *rec) {
+    uintptr_t hazards[LFQ_MAX_THREADS * LFQ_HAZARDS];
+    size_t nhazards = 0;
+    int used = atomic_load(&hp_used);
+
+    for (int i = 0; i < used; i++)
+        for (int h = 0; h < LFQ_HAZARDS; h++) {
+            LfqNode *p = atomic_load(&hp_records[i].hazard[h]);
+            if (p) hazards[nhazards++] = (uintptr_t)p;
+        }
+    qsort(hazards, nhazards, sizeof(uintptr_t), ptr_cmp);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < rec->retired_count; i++) {
+        uintptr_t p = (uintptr_t)rec->retired[i].node;
+        if (bsearch(&p, hazards, nhazards, sizeof(uintptr_t), ptr_cmp))
+            rec->retired[kept++] = rec->retired[i];
+        else
+            mem_free(rec->retired[i].node);
+    }
+    rec->retired_count = kept;
+}
+
+static void hp_retire(HpRecord *rec, LfQueue *queue, LfqNode *node) {
+    pthread_mutex_lock(&rec->retire_lock);
+    if (rec->retired_count == rec->retired_cap) {
+        size_t new_cap = rec->retired_cap ? rec->retired_cap * 2 : LFQ_SCAN_AT;
+        Retired *grown = realloc(rec->retired, new_cap * sizeof(Retired));
+        if (!grown) {
+            // utan plats att vänta kan noden inte frigöras säkert; den läcker
+            pthread_mutex_unlock(&rec->retire_lock);
+            return;
+        }
+        rec->retired = grown;
+        rec->retired_cap = new_cap;
+    }
+    rec->retired[rec->retired_count].node  = node;
+    rec->retired[rec->retired_count].queue = queue;
+    rec->retired_count++;
+
+    if (rec->retired_count >= LFQ_SCAN_AT)
+        hp_scan(rec);
+    pthread_mutex_unlock(&rec->retire_lock);
+}
+
+LfQueue *lf_queue_create(void) {
+    LfQueue *queue = mem_alloc(sizeof(LfQueue));
+    LfqNode *dummy = mem_alloc(sizeof(LfqNode));
+    if (!queue || !dummy) {
+        mem_free(queue);
+        mem_free(dummy);
+        return NULL;
+    }
+    dummy->value = NULL;
+    atomic_init(&dummy->next, NULL);
+    atomic_init(&queue->head, dummy);
+    atomic_init(&queue->tail, dummy);
+    return queue;
+}
+
+void lf_queue_destroy(LfQueue *queue) {
+    if (!queue) return;
+
+    LfqNode *node = atomic_load(&queue->head);
+    while (node) {
+        LfqNode *next = atomic_load(&node->next);
+        mem_free(node);
+        node = next;
+    }
+
+    // noder som fortfarande väntar i någon retire-lista hör till poolen
+    // och måste frigöras innan den kan tas bort
+    int used = atomic_load(&hp_used);
+    for (int i = 0; i < used; i++) {
+        HpRecord *rec = &hp_records[i];
+        pthread_mutex_lock(&rec->retire_lock);
+        size_t kept = 0;
+        for (size_t j = 0; j < rec->retired_count; j++) {
+            if (rec->retired[j].queue == queue)
+                mem_free(rec->retired[j].node);
+            else
+                rec->retired[kept++] = rec->retired[j];
+        }
+        rec->retired_count = kept;
+        pthread_mutex_unlock(&rec->retire_lock);
+    }
+    mem_free(queue);
+}
+
+int lf_queue_enqueue(LfQueue *queue, void *value) {
+    HpRecord *rec = hp_record();
+    if (!rec) return -1;
+
+    LfqNode *node = mem_alloc(sizeof(LfqNode));
+    if (!node) return -1;
+    node->value = value;
+    atomic_init(&node->next, NULL);
+
+    for (;;) {
+        LfqNode *tail = atomic_load(&queue->tail);
+        atomic_store(&rec->hazard[0], tail);
+        if (tail != atomic_load(&queue->tail))
+            continue;
+
+        LfqNode *next = atomic_load(&tail->next);
+        if (tail != atomic_load(&queue->tail))
+            continue;
+        if (next != NULL) {
+            // tail ligger efter, hjälp till att flytta fram den
+            atomic_compare_exchange_weak(&queue->tail, &tail, next);
+            continue;
+        }
+
+        LfqNode *expected = NULL;
+        if (atomic_compare_exchange_weak(&tail->next, &expected, node)) {
+            atomic_compare_exchange_strong(&queue->tail, &tail, node);
+            break;
+        }
+    }
+    atomic_store(&rec->hazard[0], NULL);
+    return 0;
+}
+
+int lf_queue_dequeue(LfQueue *queue, void **value) {
+    HpRecord *rec = hp_record();
+    if (!rec) return -1;   // inte "tom": kön kan ha värden kvar
+
+    LfqNode *head;
+    for (;;) {
+        head = atomic_load(&queue->head);
+        atomic_store(&rec->hazard[0], head);
+        if (head != atomic_load(&queue->head))
+            continue;
+
+        LfqNode *tail = atomic_load(&queue->tail);
+        LfqNode *next = atomic_load(&head->next);
+        atomic_store(&rec->hazard[1], next);
+        if (head != atomic_load(&queue->head))
+            continue;
+
+        if (next == NULL) {
+            atomic_store(&rec->hazard[0], NULL);
+            atomic_store(&rec->hazard[1], NULL);
+            return 0;
+        }
+        if (head == tail) {
+            atomic_compare_exchange_weak(&queue->tail, &tail, next);
+            continue;
+        }
+
+        void *result = next->value;
+        if (atomic_compare_exchange_weak(&queue->head, &head, next)) {
+            if (value) *value = result;
+            break;
+        }
+    }
+
+    atomic_store(&rec->hazard[0], NULL);
+    atomic_store(&rec->hazard[1], NULL);
+    hp_retire(rec, queue, head);   // den gamla dummy-noden
+    return 1;
+}
@@ -0,0 +1,28 @@
+#ifndef LF_QUEUE_H
+#define LF_QUEUE_H
+
+#include <stddef.h>   // för size_t
+#include "memory_manager.h"
+
+// Obegränsad lås-fri FIFO-kö (Michael-Scott) för flera producenter och
+// konsumenter. Noderna tas från minneshanteraren (mem_init först) och
+// återlämnas via hazard pointers när ingen tråd längre kan läsa dem
+typedef struct LfQueue LfQueue;
+
+// Skapar en tom kö, NULL om minnet inte räcker
+LfQueue* lf_queue_create(void);
+
+// Frigör kön och alla noder. Ingen tråd får använda kön samtidigt
+void lf_queue_destroy(LfQueue* queue);
+
+// Lägger value sist. Returnerar 0, eller -1 om minnet tog slut eller fler
+// trådar använder köerna än det finns hazard-poster för (LFQ_MAX_THREADS
+// i lf_queue.c)
+int lf_queue_enqueue(LfQueue* queue, void* value);
+
+// Tar första värdet till *value. Returnerar 1 om ett värde togs, 0 om kön
+// var tom, eller -1 om trådens hazard-post saknas som i lf_queue_enqueue
+// (då är kön orörd och kan ha värden kvar)
+int lf_queue_dequeue(LfQueue* queue, void** value);
+
+#endif
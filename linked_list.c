@@ -1,46 +1,988 @@
 #include "linked_list.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
 
-static pthread_mutex_t list_lock; //Lås för hela listan
+static pthread_mutex_t list_lock = PTHREAD_MUTEX_INITIALIZER; //Lås för hela listan
+
+/*
+ * Traversering av långa listor:
+ * - __builtin_prefetch på nästa nod medan den aktuella jämförs
+ * - hoppekare till var LIST_JUMP_K:e nod, sparade vid en hel genomgång.
+ *   Med dem kan LIST_JUMP_WAYS segment gås igenom samtidigt så att
+ *   cachemissarna överlappar i stället för att vänta in varandra.
+ * Kompilera med -DLIST_NO_PREFETCH för att mäta mot den gamla traverseringen.
+ */
+#define LIST_JUMP_K    16
+#define LIST_JUMP_WAYS 8
+#define LIST_JUMP_MIN  4096   // kortare listor går lika fort utan hoppekare
+
+#ifdef LIST_NO_PREFETCH
+#define LIST_PREFETCH(p) ((void)0)
+#else
+#define LIST_PREFETCH(p) __builtin_prefetch((p), 0, 1)
+#endif
+
+// Hoppekare för den lista som senast gicks igenom (skyddas av list_lock)
+static struct {
+    Node**  head;   // listan tabellen hör till
+    Node*   first;  // *head när tabellen byggdes
+    Node**  jumps;  // jumps[j] = nod nr j*LIST_JUMP_K
+    size_t  count;
+    size_t  cap;
+    int     valid;
+} jump_table;
+
+static void jumps_invalidate(void) {
+    jump_table.valid = 0;
+    jump_table.head  = NULL;
+    jump_table.first = NULL;
+    jump_table.count = 0;
+}
+
+static int jumps_usable(Node** head) {
+#ifdef LIST_NO_PREFETCH
+    (void)head;
+    return 0;
+#else
+    return jump_table.valid && jump_table.head == head &&
+           jump_table.first == *head && jump_table.count > 1;
+#endif
+}
+
+// Börjar spela in hoppekare under en genomgång av hela listan
+static void jumps_begin(Node** head) {
+    jumps_invalidate();
+    jump_table.head  = head;
+    jump_table.first = *head;
+}
+
+// Anropas för nod nr index under genomgången
+static void jumps_record(Node* node, int index) {
+    if (index % LIST_JUMP_K != 0) return;
+    if (jump_table.count == jump_table.cap) {
+        size_t new_cap = jump_table.cap ? jump_table.cap * 2 : 256;
+        Node** grown = realloc(jump_table.jumps, new_cap * sizeof(Node*));
+        if (!grown) {
+            // utan tabell blir det bara vanlig traversering
+            jump_table.head = NULL;
+            return;
+        }
+        jump_table.jumps = grown;
+        jump_table.cap   = new_cap;
+    }
+    jump_table.jumps[jump_table.count++] = node;
+}
+
+// Genomgången nådde slutet, tabellen får användas om listan är lång
+static void jumps_end(int nodes) {
+    jump_table.valid = jump_table.head != NULL && nodes >= LIST_JUMP_MIN;
+}
+
+// Sista noden i segment seg (föregångaren till segment seg+1)
+static Node* jumps_segment_last(size_t seg) {
+    Node* node = jump_table.jumps[seg];
+    while (node->next != jump_table.jumps[seg + 1])
+        node = node->next;
+    return node;
+}
+
+/*
+ * Söker med hoppekarna. Segmenten gås igenom LIST_JUMP_WAYS åt gången,
+ * ett steg per segment och varv, så att deras laddningar är oberoende.
+ * Ger första noden (i listordning) med värdet och dess föregångare.
+ */
+static Node* jumps_search(uint16_t data, Node** prev_out, size_t* seg_out) {
+    size_t segs = jump_table.count;
+    Node** jumps = jump_table.jumps;
+
+    for (size_t base = 0; base < segs; base += LIST_JUMP_WAYS) {
+        size_t ways = segs - base < LIST_JUMP_WAYS ? segs - base : LIST_JUMP_WAYS;
+        Node* cur[LIST_JUMP_WAYS];
+        Node* end[LIST_JUMP_WAYS];
+        Node* prev[LIST_JUMP_WAYS];
+        Node* hit[LIST_JUMP_WAYS];
+        size_t active = ways;
+
+        for (size_t w = 0; w < ways; w++) {
+            cur[w]  = jumps[base + w];
+            end[w]  = base + w + 1 < segs ? jumps[base + w + 1] : NULL;
+            prev[w] = NULL;
+            hit[w]  = NULL;
+        }
+
+        while (active) {
+            active = 0;
+            for (size_t w = 0; w < ways; w++) {
+                Node* node = cur[w];
+                if (node == end[w] || hit[w]) continue;
+                LIST_PREFETCH(node->next);
+                if (node->data == data) {
+                    hit[w] = node;
+                    continue;
+                }
+                prev[w] = node;
+                cur[w]  = node->next;
+                active++;
+            }
+        }
+
+        for (size_t w = 0; w < ways; w++) {
+            if (!hit[w]) continue;
+            size_t seg = base + w;
+            if (prev_out)
+                *prev_out = prev[w] ? prev[w]
+                          : (seg > 0 ? jumps_segment_last(seg - 1) : NULL);
+            if (seg_out) *seg_out = seg;
+            return hit[w];
+        }
+    }
+    return NULL;
+}
+
+// Räknar noderna med hoppekarna, segmenten stegas parallellt
+static int jumps_count(void) {
+    size_t segs = jump_table.count;
+    Node** jumps = jump_table.jumps;
+    int count = 0;
+
+    for (size_t base = 0; base < segs; base += LIST_JUMP_WAYS) {
+        size_t ways = segs - base < LIST_JUMP_WAYS ? segs - base : LIST_JUMP_WAYS;
+        Node* cur[LIST_JUMP_WAYS];
+        Node* end[LIST_JUMP_WAYS];
+        size_t active = ways;
+
+        for (size_t w = 0; w < ways; w++) {
+            cur[w] = jumps[base + w];
+            end[w] = base + w + 1 < segs ? jumps[base + w + 1] : NULL;
+        }
+
+        while (active) {
+            active = 0;
+            for (size_t w = 0; w < ways; w++) {
+                if (cur[w] == end[w]) continue;
+                LIST_PREFETCH(cur[w]->next);
+                cur[w] = cur[w]->next;
+                count++;
+                active++;
+            }
+        }
+    }
+    return count;
+}
+
+// Vanlig genomgång från *head som samtidigt spelar in hoppekare
+static Node* walk_search(Node** head, uint16_t data, Node** prev_out) {
+    Node* temp = *head;
+    Node* prev = NULL;
+    int index = 0;
+
+    jumps_begin(head);
+    while (temp) {
+        LIST_PREFETCH(temp->next);
+        if (temp->data == data) {
+            if (prev_out) *prev_out = prev;
+            jumps_invalidate();   // avbruten genomgång, tabellen är ofullständig
+            return temp;
+        }
+        jumps_record(temp, index++);
+        prev = temp;
+        temp = temp->next;
+    }
+    jumps_end(index);
+    return NULL;
+}
+
+// Hittar noden med värdet och dess föregångare, med hoppekare om de finns
+static Node* find_node(Node** head, uint16_t data, Node** prev_out, size_t* seg_out) {
+    if (seg_out) *seg_out = (size_t)-1;
+    if (jumps_usable(head))
+        return jumps_search(data, prev_out, seg_out);
+    return walk_search(head, data, prev_out);
+}
+
+/*
+ * Svansar för de senast använda listorna, så att list_insert och
+ * list_concat/list_splice kan länka in sist i O(1). Alla listor delar
+ * list_lock, som även skyddar cachen.
+ */
+#define TAIL_CACHE_SIZE 8
+
+static struct {
+    Node** head;
+    Node*  tail;
+} tail_cache[TAIL_CACHE_SIZE];
+static unsigned tail_cache_next;
+
+static void tail_forget(Node** head) {
+    for (int i = 0; i < TAIL_CACHE_SIZE; i++)
+        if (tail_cache[i].head == head)
+            tail_cache[i].head = NULL;
+}
+
+static void tail_set(Node** head, Node* tail) {
+    if (tail == NULL) {
+        tail_forget(head);
+        return;
+    }
+    for (int i = 0; i < TAIL_CACHE_SIZE; i++) {
+        if (tail_cache[i].head == head) {
+            tail_cache[i].tail = tail;
+            return;
+        }
+    }
+    unsigned i = tail_cache_next++ % TAIL_CACHE_SIZE;
+    tail_cache[i].head = head;
+    tail_cache[i].tail = tail;
+}
+
+// En ny nod har länkats in efter node (i okänd lista)
+static void tail_moved(Node* node, Node* new_tail) {
+    for (int i = 0; i < TAIL_CACHE_SIZE; i++)
+        if (tail_cache[i].head && tail_cache[i].tail == node)
+            tail_cache[i].tail = new_tail;
+}
+
+// Sista noden i listan, från cachen eller genom att gå igenom den
+static Node* list_tail(Node** head) {
+    if (*head == NULL)
+        return NULL;
+
+    for (int i = 0; i < TAIL_CACHE_SIZE; i++) {
+        if (tail_cache[i].head == head) {
+            if (tail_cache[i].tail->next == NULL)
+                return tail_cache[i].tail;
+            break;
+        }
+    }
+
+    Node* temp = *head;
+    while (temp->next != NULL) {
+        LIST_PREFETCH(temp->next->next);
+        temp = temp->next;
+    }
+    tail_set(head, temp);
+    return temp;
+}
+
+static void range_index_forget(Node** head);
 
 // Initierar listan och minneshanteraren
 void list_init(Node** head, size_t size) {
+    if (jump_table.head == head)
+        jumps_invalidate();
+    range_index_forget(head);   // ett index över en tidigare lista på samma adress gäller inte
+    tail_forget(head);
     *head = NULL;
     mem_init(size);
-    pthread_mutex_init(&list_lock, NULL);
+    // list_lock initieras statiskt; delegeringsservern kan hålla den
 }
 
-// Lägger till ny nod sist i listan
-void list_insert(Node** head, uint16_t data) {
+/*
+ * Versionerade ögonblicksbilder: list_snapshot registrerar bara versionen
+ * (O(1)), listan själv är lagringen så länge ingen skriver. Första
+ * ändringen efter det kopierar ut värdena (copy-on-write) innan noderna
+ * rörs, annars gör läsaren kopian första gången den behöver den. Därefter
+ * läses versionen helt utan list_lock.
+ */
+struct ListSnapshot {
+    Node**        head;
+    atomic_int    refs;
+    atomic_int    ready;       // 1 när values är kopierade
+    uint16_t*     values;
+    size_t        count;
+    ListSnapshot* next_pending;
+};
+
+static ListSnapshot* pending_snapshots;   // ej kopierade, skyddas av list_lock
+
+// Kopierar ut en väntande version (list_lock måste vara tagen)
+static void snapshot_materialize(ListSnapshot* snap) {
+    size_t count = 0, cap = 64;
+    uint16_t* values = malloc(cap * sizeof(uint16_t));
+
+    for (Node* temp = *snap->head; temp && values; temp = temp->next) {
+        if (count == cap) {
+            uint16_t* grown = realloc(values, cap * 2 * sizeof(uint16_t));
+            if (!grown) {
+                free(values);
+                values = NULL;
+                break;
+            }
+            values = grown;
+            cap *= 2;
+        }
+        LIST_PREFETCH(temp->next);
+        values[count++] = temp->data;
+    }
+    if (!values) {
+        printf("Minnet fullt\n");
+        count = 0;
+    }
+
+    snap->values = values;
+    snap->count  = count;
+
+    ListSnapshot** link = &pending_snapshots;
+    while (*link != snap)
+        link = &(*link)->next_pending;
+    *link = snap->next_pending;
+    atomic_store_explicit(&snap->ready, 1, memory_order_release);
+}
+
+// Anropas före varje ändring av en lista (list_lock måste vara tagen)
+static void list_changed(void) {
+    while (pending_snapshots)
+        snapshot_materialize(pending_snapshots);
+}
+
+ListSnapshot* list_snapshot(Node** head) {
     pthread_mutex_lock(&list_lock);
 
+    // ingen har skrivit sedan förra bilden av samma lista: dela versionen.
+    // En bild vars sista referens just släpps (refs == 0) väcks inte till
+    // liv, list_snapshot_release håller på att frigöra den
+    for (ListSnapshot* snap = pending_snapshots; snap; snap = snap->next_pending) {
+        if (snap->head != head)
+            continue;
+        int refs = atomic_load(&snap->refs);
+        while (refs > 0 && !atomic_compare_exchange_weak(&snap->refs, &refs, refs + 1))
+            ;
+        if (refs > 0) {
+            pthread_mutex_unlock(&list_lock);
+            return snap;
+        }
+    }
+
+    ListSnapshot* snap = malloc(sizeof(ListSnapshot));
+    if (snap) {
+        snap->head   = head;
+        snap->values = NULL;
+        snap->count  = 0;
+        atomic_init(&snap->refs, 1);
+        atomic_init(&snap->ready, 0);
+        snap->next_pending = pending_snapshots;
+        pending_snapshots  = snap;
+    }
+
+    pthread_mutex_unlock(&list_lock);
+    return snap;
+}
+
+size_t list_snapshot_values(ListSnapshot* snap, const uint16_t** values) {
+    if (!atomic_load_explicit(&snap->ready, memory_order_acquire)) {
+        pthread_mutex_lock(&list_lock);
+        if (!atomic_load_explicit(&snap->ready, memory_order_relaxed))
+            snapshot_materialize(snap);
+        pthread_mutex_unlock(&list_lock);
+    }
+    if (values) *values = snap->values;
+    return snap->count;
+}
+
+void list_snapshot_display(ListSnapshot* snap) {
+    const uint16_t* values;
+    size_t count = list_snapshot_values(snap, &values);
+
+    printf("[");
+    for (size_t i = 0; i < count; i++) {
+        printf("%u", values[i]);
+        if (i + 1 < count) printf(", ");
+    }
+    printf("]\n");
+}
+
+void list_snapshot_release(ListSnapshot* snap) {
+    if (!snap || atomic_fetch_sub(&snap->refs, 1) != 1)
+        return;
+
+    if (!atomic_load_explicit(&snap->ready, memory_order_acquire)) {
+        pthread_mutex_lock(&list_lock);
+        if (!atomic_load_explicit(&snap->ready, memory_order_relaxed)) {
+            ListSnapshot** link = &pending_snapshots;
+            while (*link != snap)
+                link = &(*link)->next_pending;
+            *link = snap->next_pending;
+        }
+        pthread_mutex_unlock(&list_lock);
+    }
+    free(snap->values);
+    free(snap);
+}
+
+/*
+ * Sorterade index (värde, nod) per lista, för list_query_range. Ett index
+ * byggs första gången en lista frågas och hålls sedan uppdaterat: insert
+ * sist och delete ändrar bara sin post (binärsökning + memmove). Insättning
+ * mitt i listan, splice och split kastar indexet för de listor det gäller,
+ * och det byggs om vid nästa fråga. Skyddas av list_lock.
+ */
+#define RANGE_INDEX_SLOTS 8   // listor som kan ha index samtidigt
+
+typedef struct {
+    uint16_t data;
+    uint32_t pos;   // plats i listan, så lika värden behåller listordningen
+    Node*    node;
+} IndexEntry;
+
+typedef struct {
+    Node**        head;       // NULL = ledig plats
+    IndexEntry*   entries;
+    size_t        count;
+    size_t        cap;
+    uint32_t      next_pos;   // pos för nästa nod sist i listan
+    unsigned long used;       // när indexet senast frågades, för återanvändning
+} RangeIndex;
+
+static RangeIndex    range_indexes[RANGE_INDEX_SLOTS];
+static unsigned long range_index_clock;
+
+static int index_entry_cmp(const void* a, const void* b) {
+    const IndexEntry* x = a;
+    const IndexEntry* y = b;
+    if (x->data != y->data) return x->data < y->data ? -1 : 1;
+    return x->pos < y->pos ? -1 : (x->pos > y->pos);
+}
+
+static RangeIndex* range_index_find(Node** head) {
+    for (int i = 0; i < RANGE_INDEX_SLOTS; i++)
+        if (range_indexes[i].head == head)
+            return &range_indexes[i];
+    return NULL;
+}
+
+// Kastar indexet för en lista (head == NULL = alla listor)
+static void range_index_forget(Node** head) {
+    for (int i = 0; i < RANGE_INDEX_SLOTS; i++)
+        if (head == NULL || range_indexes[i].head == head)
+            range_indexes[i].head = NULL;   // bufferten återanvänds
+}
+
+// Första posten med data >= value (after = 0) eller data > value (after = 1)
+static size_t range_index_bound(const RangeIndex* idx, uint16_t value, int after) {
+    size_t left = 0, right = idx->count;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (idx->entries[mid].data < value || (after && idx->entries[mid].data == value))
+            left = mid + 1;
+        else
+            right = mid;
+    }
+    return left;
+}
+
+// Ny nod sist i listan; får den inte plats kastas indexet
+static void range_index_append(Node** head, Node* node) {
+    RangeIndex* idx = range_index_find(head);
+    if (!idx) return;
+
+    if (idx->count == idx->cap) {
+        size_t new_cap = idx->cap ? idx->cap * 2 : 256;
+        IndexEntry* grown = realloc(idx->entries, new_cap * sizeof(IndexEntry));
+        if (!grown) {
+            idx->head = NULL;
+            return;
+        }
+        idx->entries = grown;
+        idx->cap = new_cap;
+    }
+
+    // sist bland lika värden, eftersom noden ligger sist i listan
+    size_t at = range_index_bound(idx, node->data, 1);
+    memmove(&idx->entries[at + 1], &idx->entries[at], (idx->count - at) * sizeof(IndexEntry));
+    idx->entries[at].data = node->data;
+    idx->entries[at].pos  = idx->next_pos++;
+    idx->entries[at].node = node;
+    idx->count++;
+}
+
+// Noden tas bort ur listan
+static void range_index_remove(Node** head, Node* node) {
+    RangeIndex* idx = range_index_find(head);
+    if (!idx) return;
+
+    for (size_t i = range_index_bound(idx, node->data, 0);
+         i < idx->count && idx->entries[i].data == node->data; i++) {
+        if (idx->entries[i].node == node) {
+            memmove(&idx->entries[i], &idx->entries[i + 1], (idx->count - i - 1) * sizeof(IndexEntry));
+            idx->count--;
+            return;
+        }
+    }
+    idx->head = NULL;   // saknades, så indexet stämmer inte
+}
+
+// Indexet för listan, byggt vid behov (list_lock måste vara tagen), NULL = minnet slut
+static RangeIndex* range_index_get(Node** head) {
+    RangeIndex* idx = range_index_find(head);
+    if (!idx) {
+        // ledig plats, annars den som frågades för längst sedan
+        idx = &range_indexes[0];
+        for (int i = 0; i < RANGE_INDEX_SLOTS && idx->head; i++)
+            if (!range_indexes[i].head || range_indexes[i].used < idx->used)
+                idx = &range_indexes[i];
+
+        idx->head  = NULL;
+        idx->count = 0;
+        for (Node* temp = *head; temp; temp = temp->next) {
+            if (idx->count == idx->cap) {
+                size_t new_cap = idx->cap ? idx->cap * 2 : 256;
+                IndexEntry* grown = realloc(idx->entries, new_cap * sizeof(IndexEntry));
+                if (!grown) return NULL;
+                idx->entries = grown;
+                idx->cap = new_cap;
+            }
+            LIST_PREFETCH(temp->next);
+            IndexEntry* e = &idx->entries[idx->count];
+            e->data = temp->data;
+            e->pos  = (uint32_t)idx->count++;
+            e->node = temp;
+        }
+        qsort(idx->entries, idx->count, sizeof(IndexEntry), index_entry_cmp);
+        idx->next_pos = (uint32_t)idx->count;
+        idx->head = head;
+    }
+    idx->used = ++range_index_clock;
+    return idx;
+}
+
+// Lägger till ny nod sist i listan (list_lock måste vara tagen)
+static void do_insert(Node** head, uint16_t data) {
+    list_changed();
     Node* new_node = (Node*)mem_alloc(sizeof(Node));
     if (!new_node) {
         printf("Minnet fullt\n");
-        pthread_mutex_unlock(&list_lock);
         return;
     }
 
     new_node->data = data;
     new_node->next = NULL;
 
-    if (*head == NULL) {
+    Node* tail = list_tail(head);
+    if (tail == NULL)
         *head = new_node;
-    } else {
-        Node* temp = *head;
-        while (temp->next != NULL)
-            temp = temp->next;
-        temp->next = new_node;
+    else
+        tail->next = new_node;
+    tail_set(head, new_node);
+    range_index_append(head, new_node);
+}
+
+// Tar bort första noden med visst värde (list_lock måste vara tagen)
+static void do_delete(Node** head, uint16_t data) {
+    if (*head == NULL)
+        return;
+    list_changed();
+
+    Node* prev = NULL;
+    size_t seg;
+    Node* temp = find_node(head, data, &prev, &seg);
+
+    if (temp == NULL)
+        return;
+
+    if (prev == NULL)
+        *head = temp->next;
+    else
+        prev->next = temp->next;
+    if (temp->next == NULL)
+        tail_set(head, prev);
+
+    // segmenten får bli kortare, men en borttagen segmentstart gör tabellen ogiltig
+    if (jump_table.head == head) {
+        if (seg != (size_t)-1 && jump_table.jumps[seg] == temp)
+            jumps_invalidate();
+        else if (prev == NULL)
+            jump_table.first = *head;
+    }
+
+    range_index_remove(head, temp);
+    mem_free(temp);
+}
+
+/*
+ * Varje tråd som använder flat combining eller delegering får ett eget
+ * index i [0, LIST_MAX_THREADS). Indexet lämnas tillbaka när tråden avslutas.
+ */
+#define LIST_MAX_THREADS 512
+
+static atomic_int     thread_in_use[LIST_MAX_THREADS];
+static atomic_int     threads_used;   // högsta index som någon gång delats ut + 1
+static pthread_key_t  thread_key;
+static pthread_once_t thread_once = PTHREAD_ONCE_INIT;
+static __thread int   my_thread_index = -1;
+
+static void thread_release(void* arg) {
+    atomic_store(&thread_in_use[(intptr_t)arg - 1], 0);
+}
+
+static void thread_create_key(void) {
+    pthread_key_create(&thread_key, thread_release);
+}
+
+// Ger trådens index, eller -1 om alla är upptagna
+static int thread_index(void) {
+    if (my_thread_index >= 0) return my_thread_index;
+    pthread_once(&thread_once, thread_create_key);
+
+    for (int i = 0; i < LIST_MAX_THREADS; i++) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&thread_in_use[i], &expected, 1)) {
+            int used = atomic_load(&threads_used);
+            while (used <= i && !atomic_compare_exchange_weak(&threads_used, &used, i + 1))
+                ;
+            my_thread_index = i;
+            pthread_setspecific(thread_key, (void*)(intptr_t)(i + 1));
+            return i;
+        }
+    }
+    return -1;
+}
+
+typedef enum { LIST_OP_INSERT, LIST_OP_DELETE, LIST_OP_SEARCH } ListOp;
+
+static Node* execute_op(ListOp op, Node** head, uint16_t data) {
+    switch (op) {
+    case LIST_OP_INSERT: do_insert(head, data); return NULL;
+    case LIST_OP_DELETE: do_delete(head, data); return NULL;
+    case LIST_OP_SEARCH: return find_node(head, data, NULL, NULL);
+    }
+    return NULL;
+}
+
+/*
+ * Flat combining: i stället för att alla trådar turas om med list_lock
+ * lägger varje tråd sin operation i en egen slot. Den tråd som får låset
+ * utför alla väntande operationer i ett svep, övriga väntar på att deras
+ * slot markeras klar. Gäller list_insert, list_delete och list_search.
+ */
+typedef struct {
+    atomic_int pending;   // 1 = operationen väntar på att utföras
+    ListOp     op;
+    Node**     head;
+    uint16_t   data;
+    Node*      result;
+} __attribute__((aligned(64))) FcSlot;
+
+static FcSlot     fc_slots[LIST_MAX_THREADS];
+static atomic_int fc_enabled;
+
+// Utför alla publicerade operationer (list_lock måste vara tagen)
+static void fc_combine(void) {
+    int used = atomic_load(&threads_used);
+    for (int i = 0; i < used; i++) {
+        FcSlot* slot = &fc_slots[i];
+        if (!atomic_load_explicit(&slot->pending, memory_order_acquire))
+            continue;
+        slot->result = execute_op(slot->op, slot->head, slot->data);
+        atomic_store_explicit(&slot->pending, 0, memory_order_release);
+    }
+}
+
+static Node* fc_run(FcSlot* slot, ListOp op, Node** head, uint16_t data) {
+    slot->op   = op;
+    slot->head = head;
+    slot->data = data;
+    atomic_store_explicit(&slot->pending, 1, memory_order_release);
+
+    while (atomic_load_explicit(&slot->pending, memory_order_acquire)) {
+        if (pthread_mutex_trylock(&list_lock) == 0) {
+            fc_combine();
+            pthread_mutex_unlock(&list_lock);
+        } else {
+            sched_yield();
+        }
+    }
+    return slot->result;
+}
+
+/*
+ * Delegering: en servertråd äger listan. Klienterna lägger operationer i
+ * var sin SPSC-ring och väntar på att servern markerar dem klara, så
+ * listan stannar i serverns cache och låset studsar inte mellan kärnor.
+ */
+#define DELEGATE_RING_SIZE 8   // tvåpotens
+#define DELEGATE_IDLE_SPINS 1024
+
+typedef struct {
+    ListOp     op;
+    Node**     head;
+    uint16_t   data;
+    Node*      result;
+    atomic_int done;
+} DelegateReq;
+
+typedef struct {
+    atomic_uint head;   // läses av servern
+    char        pad[60];
+    atomic_uint tail;   // skrivs av klienten
+    DelegateReq reqs[DELEGATE_RING_SIZE];
+} __attribute__((aligned(64))) DelegateRing;
+
+static DelegateRing delegate_rings[LIST_MAX_THREADS];
+static atomic_int   delegate_running;
+static atomic_int   delegate_inflight;   // klienter som har en operation på väg
+static pthread_t    delegate_thread;
+static pthread_mutex_t delegate_ctl = PTHREAD_MUTEX_INITIALIZER;
+
+// Servern utför allt som ligger i ringarna, returnerar antal operationer
+static int delegate_drain(void) {
+    int used = atomic_load(&threads_used);
+    int served = 0;
+    int pending = 0;
+
+    // låset tas bara när någon ring har något att göra
+    for (int i = 0; i < used && !pending; i++) {
+        DelegateRing* ring = &delegate_rings[i];
+        pending = atomic_load_explicit(&ring->head, memory_order_relaxed) !=
+                  atomic_load_explicit(&ring->tail, memory_order_acquire);
+    }
+    if (!pending)
+        return 0;
+
+    pthread_mutex_lock(&list_lock);
+    for (int i = 0; i < used; i++) {
+        DelegateRing* ring = &delegate_rings[i];
+        unsigned h = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        unsigned t = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        for (; h != t; h++) {
+            DelegateReq* req = &ring->reqs[h & (DELEGATE_RING_SIZE - 1)];
+            req->result = execute_op(req->op, req->head, req->data);
+            atomic_store_explicit(&req->done, 1, memory_order_release);
+            served++;
+        }
+        atomic_store_explicit(&ring->head, h, memory_order_release);
+    }
+    pthread_mutex_unlock(&list_lock);
+    return served;
+}
+
+static void* delegate_server(void* arg) {
+    (void)arg;
+    int idle = 0;
+
+    while (atomic_load(&delegate_running) || atomic_load(&delegate_inflight) > 0) {
+        if (delegate_drain() > 0) {
+            idle = 0;
+        } else if (++idle < DELEGATE_IDLE_SPINS) {
+            sched_yield();
+        } else {
+            usleep(100);   // ingen trafik, sluta snurra
+        }
+    }
+    return NULL;
+}
+
+static Node* delegate_run(int index, ListOp op, Node** head, uint16_t data) {
+    DelegateRing* ring = &delegate_rings[index];
+    unsigned t = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    // ringen kan inte bli full: klienten väntar in varje operation
+    DelegateReq* req = &ring->reqs[t & (DELEGATE_RING_SIZE - 1)];
+    req->op   = op;
+    req->head = head;
+    req->data = data;
+    atomic_store_explicit(&req->done, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, t + 1, memory_order_release);
+
+    while (!atomic_load_explicit(&req->done, memory_order_acquire))
+        sched_yield();
+    return req->result;
+}
+
+int list_delegate_start(void) {
+    int rc = 0;
+    pthread_mutex_lock(&delegate_ctl);
+    if (!atomic_load(&delegate_running)) {
+        atomic_store(&delegate_running, 1);
+        rc = pthread_create(&delegate_thread, NULL, delegate_server, NULL);
+        if (rc != 0)
+            atomic_store(&delegate_running, 0);
+    }
+    pthread_mutex_unlock(&delegate_ctl);
+    return rc;
+}
+
+void list_delegate_stop(void) {
+    pthread_mutex_lock(&delegate_ctl);
+    if (atomic_load(&delegate_running)) {
+        // servern tömmer ringarna tills inga klienter är kvar
+        atomic_store(&delegate_running, 0);
+        pthread_join(delegate_thread, NULL);
+    }
+    pthread_mutex_unlock(&delegate_ctl);
+}
+
+// Kör en operation via delegering, combining eller direkt med list_lock
+static Node* run_op(ListOp op, Node** head, uint16_t data) {
+    int index = -1;
+    Node* result;
+
+    if (atomic_load(&delegate_running) || atomic_load(&fc_enabled))
+        index = thread_index();
+
+    if (index >= 0 && atomic_load(&delegate_running)) {
+        atomic_fetch_add(&delegate_inflight, 1);
+        if (atomic_load(&delegate_running)) {
+            result = delegate_run(index, op, head, data);
+            atomic_fetch_sub(&delegate_inflight, 1);
+            return result;
+        }
+        atomic_fetch_sub(&delegate_inflight, 1);
     }
 
+    if (index >= 0 && atomic_load(&fc_enabled))
+        return fc_run(&fc_slots[index], op, head, data);
+
+    pthread_mutex_lock(&list_lock);
+    result = execute_op(op, head, data);
     pthread_mutex_unlock(&list_lock);
+    return result;
+}
+
+void list_set_flat_combining(int enable) {
+    atomic_store(&fc_enabled, enable != 0);
+}
+
+/*
+ * Asynkrona operationer: anroparen köar operationen och fortsätter direkt.
+ * En arbetstråd tar hela kön i ett svep, utför den under ett enda
+ * list_lock och anropar sedan callbacks / räknar upp eventfd.
+ */
+typedef struct AsyncOp {
+    ListOp          op;
+    Node**          head;
+    uint16_t        data;
+    list_async_cb   cb;
+    void*           arg;
+    Node*           result;
+    struct AsyncOp* next;
+} AsyncOp;
+
+static AsyncOp*        async_first;
+static AsyncOp*        async_last;
+static unsigned long   async_submitted;
+static unsigned long   async_completed;
+static int             async_started;
+static int             async_efd = -1;
+static pthread_t       async_thread;
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  async_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  async_done = PTHREAD_COND_INITIALIZER;
+static __thread int    in_async_worker;   // sant i arbetstråden, se list_async_flush
+
+static void* async_worker(void* arg) {
+    (void)arg;
+    in_async_worker = 1;
+
+    for (;;) {
+        pthread_mutex_lock(&async_lock);
+        while (async_first == NULL)
+            pthread_cond_wait(&async_work, &async_lock);
+        AsyncOp* batch = async_first;
+        async_first = async_last = NULL;
+        int efd = async_efd;
+        pthread_mutex_unlock(&async_lock);
+
+        uint64_t n = 0;
+        pthread_mutex_lock(&list_lock);
+        for (AsyncOp* op = batch; op; op = op->next, n++)
+            op->result = execute_op(op->op, op->head, op->data);
+        pthread_mutex_unlock(&list_lock);
+
+        // callbacks körs utanför list_lock så att de får använda listan
+        while (batch) {
+            AsyncOp* next = batch->next;
+            if (batch->cb)
+                batch->cb(batch->result, batch->arg);
+            free(batch);
+            batch = next;
+        }
+        if (efd >= 0 && write(efd, &n, sizeof(n)) < 0)
+            perror("list async: eventfd");
+
+        pthread_mutex_lock(&async_lock);
+        async_completed += n;
+        pthread_cond_broadcast(&async_done);
+        pthread_mutex_unlock(&async_lock);
+    }
+    return NULL;
+}
+
+static int async_submit(ListOp kind, Node** head, uint16_t data, list_async_cb cb, void* arg) {
+    AsyncOp* op = malloc(sizeof(AsyncOp));
+    if (!op) return -1;
+    op->op   = kind;
+    op->head = head;
+    op->data = data;
+    op->cb   = cb;
+    op->arg  = arg;
+    op->next = NULL;
+
+    pthread_mutex_lock(&async_lock);
+    if (!async_started) {
+        if (pthread_create(&async_thread, NULL, async_worker, NULL) != 0) {
+            pthread_mutex_unlock(&async_lock);
+            free(op);
+            return -1;
+        }
+        pthread_detach(async_thread);
+        async_started = 1;
+    }
+    if (async_last)
+        async_last->next = op;
+    else
+        async_first = op;
+    async_last = op;
+    async_submitted++;
+    pthread_cond_signal(&async_work);
+    pthread_mutex_unlock(&async_lock);
+    return 0;
+}
+
+int list_insert_async(Node** head, uint16_t data, list_async_cb cb, void* arg) {
+    return async_submit(LIST_OP_INSERT, head, data, cb, arg);
+}
+
+int list_delete_async(Node** head, uint16_t data, list_async_cb cb, void* arg) {
+    return async_submit(LIST_OP_DELETE, head, data, cb, arg);
+}
+
+int list_search_async(Node** head, uint16_t data, list_async_cb cb, void* arg) {
+    return async_submit(LIST_OP_SEARCH, head, data, cb, arg);
+}
+
+void list_async_set_eventfd(int efd) {
+    pthread_mutex_lock(&async_lock);
+    async_efd = efd;
+    pthread_mutex_unlock(&async_lock);
+}
+
+void list_async_flush(void) {
+    // från en callback skulle arbetstråden vänta på sig själv
+    if (in_async_worker)
+        return;
+
+    pthread_mutex_lock(&async_lock);
+    unsigned long target = async_submitted;
+    while (async_completed < target)
+        pthread_cond_wait(&async_done, &async_lock);
+    pthread_mutex_unlock(&async_lock);
+}
+
+// Lägger till ny nod sist i listan
+void list_insert(Node** head, uint16_t data) {
+    run_op(LIST_OP_INSERT, head, data);
 }
 
 // Lägger till en ny nod direkt efter en vald nod
 void list_insert_after(Node* prev_node, uint16_t data) {
     if (prev_node == NULL) return;
     pthread_mutex_lock(&list_lock);
+    list_changed();
 
     Node* new_node = (Node*)mem_alloc(sizeof(Node));
     if (!new_node) {
@@ -52,6 +994,9 @@ void list_insert_after(Node* prev_node, uint16_t data) {
     new_node->data = data;
     new_node->next = prev_node->next;
     prev_node->next = new_node;
+    if (new_node->next == NULL)
+        tail_moved(prev_node, new_node);
+    range_index_forget(NULL);   // vilken lista noden hör till är okänt
 
     pthread_mutex_unlock(&list_lock);
 }
@@ -60,6 +1005,7 @@ void list_insert_after(Node* prev_node, uint16_t data) {
 void list_insert_before(Node** head, Node* next_node, uint16_t data) {
     if (next_node == NULL || head == NULL) return;
     pthread_mutex_lock(&list_lock);
+    list_changed();
 
     Node* new_node = (Node*)mem_alloc(sizeof(Node));
     if (!new_node) {
@@ -69,6 +1015,7 @@ void list_insert_before(Node** head, Node* next_node, uint16_t data) {
     }
 
     new_node->data = data;
+    range_index_forget(head);   // platserna efter den nya noden flyttas
 
     // Om det är 1a noden
     if (*head == next_node) {
@@ -92,103 +1039,209 @@ void list_insert_before(Node** head, Node* next_node, uint16_t data) {
 
 // tar bort en nod med visst värde
 void list_delete(Node** head, uint16_t data) {
-    pthread_mutex_lock(&list_lock);
-
-    if (*head == NULL) {
-        pthread_mutex_unlock(&list_lock);
-        return;
-    }
+    run_op(LIST_OP_DELETE, head, data);
+}
 
-    Node* temp = *head;
-    Node* prev = NULL;
+// Söker efter en nod med visst värde
+Node* list_search(Node** head, uint16_t data) {
+    return run_op(LIST_OP_SEARCH, head, data);
+}
 
-    while (temp && temp->data != data) {
-        prev = temp;
-        temp = temp->next;
-    }
+/*
+ * Flytt av hela segment mellan listor: bara pekare länkas om, inga noder
+ * allokeras eller frigörs. Alla listor delar list_lock, så två listor
+ * kan inte låsas i olika ordning.
+ */
+static void relinked(Node** head) {
+    if (jump_table.head == head)
+        jumps_invalidate();
+    range_index_forget(head);
+}
 
-    if (temp == NULL) {
-        pthread_mutex_unlock(&list_lock);
+// Länkar in hela *src efter noden after i *dst (after == NULL = först)
+static void do_splice(Node** dst, Node* after, Node** src) {
+    Node* first = *src;
+    if (first == NULL || dst == src)
         return;
+    list_changed();
+
+    Node* last = list_tail(src);
+    if (after == NULL) {
+        last->next = *dst;
+        if (*dst == NULL)
+            tail_set(dst, last);
+        *dst = first;
+    } else {
+        last->next = after->next;
+        after->next = first;
+        if (last->next == NULL)
+            tail_moved(after, last);
     }
 
-    if (prev == NULL)
-        *head = temp->next;
-    else
-        prev->next = temp->next;
+    *src = NULL;
+    tail_forget(src);
+    relinked(dst);
+    relinked(src);
+}
 
-    mem_free(temp);
+void list_splice(Node** dst, Node* after, Node** src) {
+    if (dst == NULL || src == NULL) return;
+    pthread_mutex_lock(&list_lock);
+    do_splice(dst, after, src);
     pthread_mutex_unlock(&list_lock);
 }
 
-// Söker efter en nod med visst värde
-Node* list_search(Node** head, uint16_t data) {
+void list_concat(Node** dst, Node** src) {
+    if (dst == NULL || src == NULL) return;
     pthread_mutex_lock(&list_lock);
-    Node* current = *head;
+    do_splice(dst, list_tail(dst), src);
+    pthread_mutex_unlock(&list_lock);
+}
 
-    while (current) {
-        if (current->data == data) {
-            pthread_mutex_unlock(&list_lock);
-            return current;
-        }
-        current = current->next;
+void list_split_at(Node** head, Node* node, Node** rest) {
+    if (head == NULL || rest == NULL || head == rest) return;
+    pthread_mutex_lock(&list_lock);
+    list_changed();
+
+    Node* old_tail = NULL;
+    for (int i = 0; i < TAIL_CACHE_SIZE; i++)
+        if (tail_cache[i].head == head)
+            old_tail = tail_cache[i].tail;
+
+    if (node == NULL) {
+        *rest = *head;
+        *head = NULL;
+    } else {
+        *rest = node->next;
+        node->next = NULL;
     }
 
+    tail_set(head, node);
+    if (*rest && old_tail && old_tail->next == NULL)
+        tail_set(rest, old_tail);
+    else
+        tail_forget(rest);
+    relinked(head);
+    relinked(rest);
+
     pthread_mutex_unlock(&list_lock);
-    return NULL;
 }
 
 // Skriver ut hela listan
+// (via en ögonblicksbild, så list_lock hålls inte under utskriften)
 void list_display(Node** head) {
-    pthread_mutex_lock(&list_lock);
-    Node* temp = *head;
+    ListSnapshot* snap = list_snapshot(head);
+    if (!snap) {
+        printf("Minnet fullt\n");
+        return;
+    }
+    list_snapshot_display(snap);
+    list_snapshot_release(snap);
+}
 
-    printf("[");
+// Lägger till text i buf som snprintf, men räknar vidare när den är full
+static size_t append_str(char* buf, size_t size, size_t len, const char* text) {
+    char* dst = len < size ? buf + len : NULL;
+    int n = snprintf(dst, dst ? size - len : 0, "%s", text);
+    return len + (n > 0 ? (size_t)n : 0);
+}
+
+// Som append_str, för ett nodvärde i decimal form
+static size_t append_u16(char* buf, size_t size, size_t len, uint16_t value) {
+    char* dst = len < size ? buf + len : NULL;
+    int n = snprintf(dst, dst ? size - len : 0, "%u", (unsigned)value);
+    return len + (n > 0 ? (size_t)n : 0);
+}
+
+// Formaterar start_node..end_node (list_lock måste vara tagen)
+static size_t format_range(Node** head, Node* start_node, Node* end_node, char* buf, size_t size) {
+    size_t len = 0;
+    Node* temp = start_node ? start_node : *head;
+
+    if (size > 0) buf[0] = '\0';
+    len = append_str(buf, size, len, "[");
     while (temp) {
-        printf("%u", temp->data);
-        if (temp->next) printf(", ");
+        LIST_PREFETCH(temp->next);
+        len = append_u16(buf, size, len, temp->data);
+        if (temp == end_node) break;
+        if (temp->next != NULL)
+            len = append_str(buf, size, len, ", ");
         temp = temp->next;
     }
-    printf("]\n");
+    return append_str(buf, size, len, "]\n");
+}
 
+size_t list_format_range(Node** head, Node* start_node, Node* end_node, char* buf, size_t size) {
+    pthread_mutex_lock(&list_lock);
+    size_t len = format_range(head, start_node, end_node, buf, size);
     pthread_mutex_unlock(&list_lock);
+    return len;
 }
 
-// Skriver ut noder mellan de två givna noder
+// Skriver ut noder mellan de två givna noder, från start_node direkt
 void list_display_range(Node** head, Node* start_node, Node* end_node) {
+    char small[256];
+    char* buf = small;
+
     pthread_mutex_lock(&list_lock);
-    Node* temp = *head;
+    size_t len = format_range(head, start_node, end_node, small, sizeof(small));
+    if (len >= sizeof(small)) {
+        buf = malloc(len + 1);
+        if (buf)
+            format_range(head, start_node, end_node, buf, len + 1);
+    }
+    pthread_mutex_unlock(&list_lock);
 
-    if (start_node == NULL)
-        start_node = *head;
+    if (!buf) {
+        printf("Minnet fullt\n");
+        return;
+    }
+    fputs(buf, stdout);
+    if (buf != small)
+        free(buf);
+}
 
-    int printing = 0;
-    printf("[");
+size_t list_query_range(Node** head, uint16_t lo, uint16_t hi, Node** out, size_t cap) {
+    size_t found = 0;
+    if (lo > hi) return 0;
 
-    while (temp) {
-        if (temp == start_node) printing = 1;
-        if (printing) {
-            printf("%u", temp->data);
-            if (temp != end_node && temp->next != NULL) printf(", ");
-        }
-        if (temp == end_node) break;
-        temp = temp->next;
+    pthread_mutex_lock(&list_lock);
+    RangeIndex* idx = range_index_get(head);
+    if (!idx) {
+        pthread_mutex_unlock(&list_lock);
+        printf("Minnet fullt\n");
+        return 0;
+    }
+
+    for (size_t i = range_index_bound(idx, lo, 0); i < idx->count && idx->entries[i].data <= hi; i++) {
+        if (found < cap)
+            out[found] = idx->entries[i].node;
+        found++;
     }
 
-    printf("]\n");
     pthread_mutex_unlock(&list_lock);
+    return found;
 }
 
 // Räknar antalet noder i listan
 int list_count_nodes(Node** head) {
     pthread_mutex_lock(&list_lock);
     int count = 0;
-    Node* temp = *head;
 
+    if (jumps_usable(head)) {
+        count = jumps_count();
+        pthread_mutex_unlock(&list_lock);
+        return count;
+    }
+
+    Node* temp = *head;
+    jumps_begin(head);
     while (temp) {
-        count++;
+        LIST_PREFETCH(temp->next);
+        jumps_record(temp, count++);
         temp = temp->next;
     }
+    jumps_end(count);
 
     pthread_mutex_unlock(&list_lock);
     return count;
@@ -196,7 +1249,9 @@ int list_count_nodes(Node** head) {
 
 // Frigör alla noder och nollställer listan
 void list_cleanup(Node** head) {
+    list_async_flush(); // köade operationer måste köras innan poolen försvinner
     pthread_mutex_lock(&list_lock);
+    list_changed();
 
     Node* current = *head;
     Node* next;
@@ -207,8 +1262,11 @@ void list_cleanup(Node** head) {
     }
 
     *head = NULL;
+    jumps_invalidate();
+    for (int i = 0; i < TAIL_CACHE_SIZE; i++)
+        tail_cache[i].head = NULL;   // poolen försvinner med alla listors noder
+    range_index_forget(NULL);
     mem_deinit();
 
     pthread_mutex_unlock(&list_lock);
-    pthread_mutex_destroy(&list_lock);
 }
@@ -6,12 +6,19 @@
 #include <pthread.h>  // för trådsäkerhet
 #include "memory_manager.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // Nodstruktur för den länkade listan
 typedef struct Node {
     uint16_t data;      // värdet i noden
     struct Node* next;  // pekare till nästa nod
 } Node;
 
+// Oföränderlig version av en lista, se list_snapshot
+typedef struct ListSnapshot ListSnapshot;
+
 // Initierar listan och minneshanteraren
 void list_init(Node** head, size_t size);
 
@@ -30,16 +37,82 @@ void list_delete(Node** head, uint16_t data);
 // Söker efter en nod med ett visst värde
 Node* list_search(Node** head, uint16_t data);
 
+// Länkar in hela listan *src efter noden after i *dst (after == NULL = först).
+// *src blir tom. Inga noder kopieras
+void list_splice(Node** dst, Node* after, Node** src);
+
+// Delar listan efter node: noderna efter node flyttas till *rest.
+// node == NULL flyttar hela listan
+void list_split_at(Node** head, Node* node, Node** rest);
+
+// Lägger hela listan *src sist i *dst, *src blir tom
+void list_concat(Node** dst, Node** src);
+
 // Skriver ut hela listan
 void list_display(Node** head);
 
-// Skriver ut noder mellan två givna noder
+// Skriver ut noder mellan två givna noder. Utskriften börjar direkt vid
+// start_node (NULL = första noden) och slutar vid end_node eller listans slut
 void list_display_range(Node** head, Node* start_node, Node* end_node);
 
+// Som list_display_range men skriver till buf i stället för stdout.
+// Returnerar längden hela texten behöver, som snprintf
+size_t list_format_range(Node** head, Node* start_node, Node* end_node, char* buf, size_t size);
+
+// Lägger noder med lo <= data <= hi i out (högst cap st, sorterade på värde)
+// via ett sorterat index. Returnerar totala antalet träffar
+size_t list_query_range(Node** head, uint16_t lo, uint16_t hi, Node** out, size_t cap);
+
 // Räknar antalet noder i listan
 int list_count_nodes(Node** head);
 
 // Frigör alla noder och rensar listan
 void list_cleanup(Node** head);
 
+// Slår på/av flat combining för list_insert, list_delete och list_search:
+// den tråd som får låset utför alla trådars väntande operationer i ett svep
+void list_set_flat_combining(int enable);
+
+// Startar en servertråd som äger listan: list_insert, list_delete och
+// list_search skickas dit via per-tråd-ringar. Returnerar 0 vid lyckad start
+int list_delegate_start(void);
+
+// Stoppar servertråden när alla pågående operationer är klara
+void list_delegate_stop(void);
+
+// Anropas från arbetstråden när en asynkron operation är utförd.
+// result är funnen nod för list_search_async, annars NULL
+typedef void (*list_async_cb)(Node* result, void* arg);
+
+// Köar en operation och returnerar direkt (0 = köad, -1 = minnet slut).
+// Köade operationer utförs i omgångar av en arbetstråd; cb får vara NULL
+int list_insert_async(Node** head, uint16_t data, list_async_cb cb, void* arg);
+int list_delete_async(Node** head, uint16_t data, list_async_cb cb, void* arg);
+int list_search_async(Node** head, uint16_t data, list_async_cb cb, void* arg);
+
+// Räknar upp en eventfd med antalet utförda operationer efter varje omgång (-1 = av)
+void list_async_set_eventfd(int efd);
+
+// Väntar tills alla hittills köade operationer är utförda. Från en
+// callback (i arbetstråden) returnerar den direkt utan att vänta
+void list_async_flush(void);
+
+// Tar en ögonblicksbild av listan i O(1). Värdena kopieras först när någon
+// skriver till listan eller bilden läses, därefter läses den utan list_lock.
+// Bilder som tas utan ändringar emellan delar samma version
+ListSnapshot* list_snapshot(Node** head);
+
+// Ger bildens värden i listordning och antalet värden
+size_t list_snapshot_values(ListSnapshot* snap, const uint16_t** values);
+
+// Skriver ut bilden i samma format som list_display
+void list_snapshot_display(ListSnapshot* snap);
+
+// Släpper en referens till bilden
+void list_snapshot_release(ListSnapshot* snap);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
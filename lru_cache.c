@@ -0,0 +1,239 @@
+#include "lru_cache.h"
+
+#include <pthread.h>
+#include <string.h>
+
+/*
+ * LRU-cache ovanpå minneshanteraren:
+ * - varje shard har eget lås, hashtabell och användningslista
+ * - get, put och eviction är O(1); en undanträngd post återanvänds
+ *   direkt för den nya nyckeln i stället för mem_free + mem_alloc
+ */
+
+typedef struct LruEntry {
+    uint32_t         key;
+    void            *value;
+    struct LruEntry *hnext;   // nästa i samma hashhink
+    struct LruEntry *prev;    // mot senast använd
+    struct LruEntry *next;    // mot minst nyligen använd
+} LruEntry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    LruEntry      **buckets;
+    size_t          mask;      // antal hinkar - 1
+    LruEntry       *mru;       // senast använd
+    LruEntry       *lru;       // minst nyligen använd
+    size_t          size;
+    size_t          capacity;
+    unsigned long   hits;
+    unsigned long   misses;
+    unsigned long   evictions;
+    char            pad[64];   // håller grannshardens lås på en annan cacherad
+} LruShard;
+
+struct LruCache {
+    LruShard     *shards;
+    size_t        num_shards;
+    lru_evict_cb  on_evict;
+    void         *evict_arg;
+};
+
+// Fibonacci-hash; höga bitar väljer shard, låga bitar hink
+static uint32_t lru_hash(uint32_t key) {
+    return key * 2654435761u;
+}
+
+static LruShard *shard_for(LruCache *cache, uint32_t hash) {
+    return &cache->shards[(hash >> 16) % cache->num_shards];
+}
+
+static LruEntry **bucket_for(LruShard *shard, uint32_t hash) {
+    return &shard->buckets[hash & shard->mask];
+}
+
+static void list_unlink(LruShard *shard, LruEntry *e) {
+    if (e->prev) e->prev->next = e->next; else shard->mru = e->next;
+    if (e->next) e->next->prev = e->prev; else shard->lru = e->prev;
+}
+
+static void list_push_front(LruShard *shard, LruEntry *e) {
+    e->prev = NULL;
+    e->next = shard->mru;
+    if (shard->mru) shard->mru->prev = e; else shard->lru = e;
+    shard->mru = e;
+}
+
+// Tar bort e ur hinken (e måste finnas där)
+static void bucket_remove(LruShard *shard, LruEntry *e) {
+    LruEntry **link = bucket_for(shard, lru_hash(e->key));
+    while (*link != e)
+        link = &(*link)->hnext;
+    *link = e->hnext;
+}
+
+static LruEntry *bucket_find(LruShard *shard, uint32_t key, uint32_t hash) {
+    LruEntry *e = *bucket_for(shard, hash);
+    while (e && e->key != key)
+        e = e->hnext;
+    return e;
+}
+
+LruCache *lru_create(size_t capacity, size_t num_shards, lru_evict_cb on_evict, void *evict_arg) {
+    if (capacity == 0) return NULL;
+    if (num_shards == 0) num_shards = 1;
+    if (num_shards > capacity) num_shards = capacity;
+
+    LruCache *cache = mem_alloc(sizeof(LruCache));
+    if (!cache) return NULL;
+    cache->shards = mem_alloc(num_shards * sizeof(LruShard));
+    if (!cache->shards) {
+        mem_free(cache);
+        return NULL;
+    }
+    cache->num_shards = num_shards;
+    cache->on_evict   = on_evict;
+    cache->evict_arg  = evict_arg;
+
+    size_t per_shard = (capacity + num_shards - 1) / num_shards;
+    size_t nbuckets = 1;
+    while (nbuckets < per_shard)
+        nbuckets <<= 1;
+
+    for (size_t i = 0; i < num_shards; i++) {
+        LruShard *shard = &cache->shards[i];
+        memset(shard, 0, sizeof(*shard));
+        shard->capacity = per_shard;
+        shard->mask     = nbuckets - 1;
+        shard->buckets  = mem_alloc(nbuckets * sizeof(LruEntry *));
+        if (!shard->buckets) {
+            cache->num_shards = i;
+            lru_destroy(cache);
+            return NULL;
+        }
+        memset(shard->buckets, 0, nbuckets * sizeof(LruEntry *));
+        pthread_mutex_init(&shard->lock, NULL);
+    }
+    return cache;
+}
+
+void lru_destroy(LruCache *cache) {
+    if (!cache) return;
+    for (size_t i = 0; i < cache->num_shards; i++) {
+        LruShard *shard = &cache->shards[i];
+        LruEntry *e = shard->mru;
+        while (e) {
+            LruEntry *next = e->next;
+            mem_free(e);
+            e = next;
+        }
+        mem_free(shard->buckets);
+        pthread_mutex_destroy(&shard->lock);
+    }
+    mem_free(cache->shards);
+    mem_free(cache);
+}
+
+int lru_get(LruCache *cache, uint32_t key, void **value) {
+    uint32_t hash = lru_hash(key);
+    LruShard *shard = shard_for(cache, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    LruEntry *e = bucket_find(shard, key, hash);
+    if (!e) {
+        shard->misses++;
+        pthread_mutex_unlock(&shard->lock);
+        return 0;
+    }
+    shard->hits++;
+    if (shard->mru != e) {
+        list_unlink(shard, e);
+        list_push_front(shard, e);
+    }
+    if (value) *value = e->value;
+    pthread_mutex_unlock(&shard->lock);
+    return 1;
+}
+
+int lru_put(LruCache *cache, uint32_t key, void *value) {
+    uint32_t hash = lru_hash(key);
+    LruShard *shard = shard_for(cache, hash);
+    uint32_t evicted_key = 0;
+    void *evicted_value = NULL;
+    int evicted = 0;
+
+    pthread_mutex_lock(&shard->lock);
+    LruEntry *e = bucket_find(shard, key, hash);
+    if (e) {
+        e->value = value;
+        if (shard->mru != e) {
+            list_unlink(shard, e);
+            list_push_front(shard, e);
+        }
+        pthread_mutex_unlock(&shard->lock);
+        return 0;
+    }
+
+    if (shard->size >= shard->capacity) {
+        // återanvänd den minst nyligen använda posten
+        e = shard->lru;
+        list_unlink(shard, e);
+        bucket_remove(shard, e);
+        evicted_key   = e->key;
+        evicted_value = e->value;
+        evicted       = 1;
+        shard->evictions++;
+        shard->size--;
+    } else {
+        e = mem_alloc(sizeof(LruEntry));
+        if (!e) {
+            pthread_mutex_unlock(&shard->lock);
+            return -1;
+        }
+    }
+
+    e->key   = key;
+    e->value = value;
+    LruEntry **bucket = bucket_for(shard, hash);
+    e->hnext = *bucket;
+    *bucket  = e;
+    list_push_front(shard, e);
+    shard->size++;
+    pthread_mutex_unlock(&shard->lock);
+
+    // callbacken körs utan lås så att den får använda cachen
+    if (evicted && cache->on_evict)
+        cache->on_evict(evicted_key, evicted_value, cache->evict_arg);
+    return 0;
+}
+
+int lru_remove(LruCache *cache, uint32_t key) {
+    uint32_t hash = lru_hash(key);
+    LruShard *shard = shard_for(cache, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    LruEntry *e = bucket_find(shard, key, hash);
+    if (e) {
+        list_unlink(shard, e);
+        bucket_remove(shard, e);
+        shard->size--;
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    if (!e) return 0;
+    mem_free(e);
+    return 1;
+}
+
+void lru_get_stats(LruCache *cache, LruStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    for (size_t i = 0; i < cache->num_shards; i++) {
+        LruShard *shard = &cache->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        stats->hits      += shard->hits;
+        stats->misses    += shard->misses;
+        stats->evictions += shard->evictions;
+        stats->size      += shard->size;
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
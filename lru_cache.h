@@ -0,0 +1,44 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <stdint.h>   // för uint32_t
+#include <stddef.h>   // för size_t
+#include "memory_manager.h"
+
+// LRU-cache med hashindex och dubbellänkad användningsordning, uppdelad i
+// shards efter nyckel. Allt minne tas från minneshanteraren (mem_init först)
+typedef struct LruCache LruCache;
+
+// Räknare summerade över alla shards
+typedef struct {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    size_t        size;       // antal poster just nu
+} LruStats;
+
+// Anropas när en post trängs undan, t.ex. för att frigöra värdet
+typedef void (*lru_evict_cb)(uint32_t key, void* value, void* arg);
+
+// Skapar en cache för capacity poster fördelade på num_shards shards.
+// on_evict får vara NULL. Returnerar NULL om minnet inte räcker
+LruCache* lru_create(size_t capacity, size_t num_shards, lru_evict_cb on_evict, void* evict_arg);
+
+// Frigör cachen och alla poster (on_evict anropas inte)
+void lru_destroy(LruCache* cache);
+
+// Hämtar värdet för key och markerar posten som senast använd.
+// Returnerar 1 vid träff, 0 annars
+int lru_get(LruCache* cache, uint32_t key, void** value);
+
+// Lägger in eller uppdaterar key. Är shardet fullt trängs den minst nyligen
+// använda posten undan. Returnerar 0, eller -1 om minnet tog slut
+int lru_put(LruCache* cache, uint32_t key, void* value);
+
+// Tar bort key, returnerar 1 om den fanns
+int lru_remove(LruCache* cache, uint32_t key);
+
+// Läser räknarna
+void lru_get_stats(LruCache* cache, LruStats* stats);
+
+#endif
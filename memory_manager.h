@@ -3,20 +3,255 @@
 
 #include <stddef.h>   // för size_t
 #include <pthread.h>  // för trådsäkerhet
+#include <stdint.h>   // för uintptr_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 // Initierar minneshanteraren med en viss pool-storlek
 void mem_init(size_t size);
 
+#define MM_PROFILE_MAX 32     // storleksklasser i en profil
+#define MM_HIST_MAX    1024   // förfrågningar upp till så här många byte räknas per storlek
+
+// En rad i en profil: klassen tar förfrågningar större än föregående
+// klass och upp till size byte; count block skärs ut i förväg
+struct mm_profile_entry {
+    size_t size;
+    size_t count;
+};
+
+// Val till mem_init_opts
+struct mm_init_opts {
+    int      prefault;   // rör alla sidor i poolen (och i regioner från mem_grow) direkt
+    unsigned threads;    // trådar för prefault, 0 = efter poolens storlek
+    const struct mm_profile_entry *profile;   // klasser att skära ut, eller NULL
+    size_t   profile_len;                     // högst MM_PROFILE_MAX
+    size_t   tune_interval;   // räkna om klasserna efter så många allokeringar, 0 = aldrig
+    size_t   tune_classes;    // högst så många klasser vid omräkning, 0 = MM_PROFILE_MAX
+};
+
+// Som mem_init, men med val; opts == NULL ger samma sak som mem_init.
+// Med prefault betalas sidfelen i mem_init i stället för vid de första
+// allokeringarna; tiden syns som warmup_ns i mem_stats. Med en profil
+// delas början av poolen upp i färdiga block per klass, som mem_alloc
+// tar ur en fri-lista utan att söka och dela. Sådana block slås aldrig
+// ihop med grannarna. När en klass är tom skärs en ny slab ut ur poolen.
+// Med tune_interval räknas klasserna om från histogrammet (se
+// mem_tune_classes) medan programmet kör
+void mem_init_opts(size_t size, const struct mm_init_opts *opts);
+
 // Allokerar ett block av angiven storlek från poolen
 void* mem_alloc(size_t size);
 
 // Frigör ett tidigare allokerat block
 void mem_free(void* block);
 
+// Var i poolen mem_alloc_hint lägger blocket
+typedef enum {
+    MM_HINT_NONE,          // som mem_alloc
+    MM_HINT_LONG_LIVED,    // längst ner i poolen (first-fit), som mem_alloc
+    MM_HINT_SHORT_LIVED,   // längst upp (last-fit från toppen), så att kortlivade
+                           // block inte lämnar hål mellan de långlivade
+    MM_HINT_HOT            // direkt efter föregående HOT-block i en reserv om
+                           // 64 KiB, så att heta objekt delar cachelinjer och sidor
+} mm_alloc_hint;
+
+// Som mem_alloc, men placerar blocket efter hinten. SHORT_LIVED och HOT
+// tar inte block ur storleksklasserna (se mem_init_opts)
+void* mem_alloc_hint(size_t size, mm_alloc_hint hint);
+
+// Allokerar n * size nollställda byte. Minne som redan är känt noll (en
+// ny pool, eller stora fria block som lämnats tillbaka till OS) nollas
+// inte igen. NULL vid overflow eller om ingen plats finns
+void* mem_calloc(size_t n, size_t size);
+
+// Som mem_alloc men datadelen börjar på en multipel av align (en
+// tvåpotens). Gapet före blir ett eget fritt block. NULL om align inte
+// är en tvåpotens eller om ingen plats finns
+void* mem_alloc_aligned(size_t size, size_t align);
+
+// Frigör ett block vars storlek anroparen känner till (size högst den
+// begärda storleken), som en sized delete i C++. En för stor size är ett
+// fel (assert); utan assert frigörs blocket som med mem_free
+void mem_free_sized(void* block, size_t size);
+
 // Ändrar storleken på ett block (flyttar det om det behövs)
 void* mem_resize(void* block, size_t size);
 
 // Rensar hela poolen och frigör allt minne
 void mem_deinit(void);
 
+// Utökar poolen med en ny region om size byte (efter mem_init). Regionen
+// ligger inte intill poolen, så inget block kan spänna över båda.
+// Returnerar 0, eller -1 om minnet eller antalet regioner tog slut
+int mem_grow(size_t size);
+
+// Antal användbara byte i blocket (minst den begärda storleken), 0 för
+// pekare som inte kommer från poolen
+size_t mem_usable_size(void* block);
+
+// Ögonblicksbild av poolen
+struct mm_stats {
+    size_t   pool_size;        // poolen plus regionerna från mem_grow
+    size_t   free_bytes;       // datadelar i fria block
+    size_t   free_blocks;
+    size_t   largest_free;
+    size_t   hot_reserve;      // oanvänd del av reserven för MM_HINT_HOT
+    uint64_t warmup_ns;        // tid för mappning och prefault sedan mem_init_opts
+    unsigned warmup_threads;   // trådar i senaste prefault
+    size_t   carved_blocks;    // förskurna block som ligger fria i klasslistorna
+    size_t   carved_bytes;
+    size_t   num_classes;      // storleksklasserna just nu
+    size_t   classes[MM_PROFILE_MAX];
+    unsigned long tunings;     // omräkningar sedan mem_init
+    uint64_t waste_before;     // intern förlust i byte före och efter senaste
+    uint64_t waste_after;      // omräkningen, uppskattad på histogrammets peak_live
+    size_t   live_waste;       // mätt: datadel minus begärd storlek för levande block
+    uint64_t trimmed_bytes;    // fria block som lämnats tillbaka till OS sedan mem_init
+};
+
+void mem_stats(struct mm_stats *out);
+
+// Begärda storlekar sedan senaste mem_init. Index är storleken i byte,
+// sista platsen samlar allt över MM_HIST_MAX. peak_live är det största
+// antalet samtidigt levande block av storleken
+struct mm_size_hist {
+    uint64_t allocs[MM_HIST_MAX + 2];
+    uint64_t live[MM_HIST_MAX + 2];
+    uint64_t peak_live[MM_HIST_MAX + 2];
+};
+
+// Läser histogrammet; går att göra efter mem_deinit
+void mem_size_histogram(struct mm_size_hist *out);
+
+// Gör en profil av ett histogram med högst max klasser, valda så att den
+// interna förlusten (avrundning till 8 byte och till klassen) viktad med
+// peak_live blir så liten som möjligt. count blir summan av peak_live för
+// storlekarna klassen tar. Returnerar antalet klasser
+size_t mem_profile_from_histogram(const struct mm_size_hist *hist,
+                                  struct mm_profile_entry *out, size_t max);
+
+// Räknar om storleksklasserna från histogrammet, som i
+// mem_profile_from_histogram, och byter till dem om förlusten blir
+// mindre. Klasser som försvinner lämnar tillbaka sina fria block till
+// poolen; nya klasser får slabs när de behövs. Returnerar antalet klasser
+int mem_tune_classes(size_t max);
+
+// Sparar en profil som text, en klass per rad ("size count"). 0 eller -1
+int mem_profile_save(const char *path, const struct mm_profile_entry *profile, size_t len);
+
+// Läser en profil sparad med mem_profile_save. Antal klasser, -1 vid fel
+int mem_profile_load(const char *path, struct mm_profile_entry *out, size_t max);
+
+// Lämnar tillbaka blocken i den anropande trådens cache (se
+// MM_INLINE_FASTPATH nedan). Sker automatiskt när en tråd avslutas
+void mem_flush_cache(void);
+
+/*
+ * Inline snabbväg, slås på med -DMM_INLINE_FASTPATH före inkluderingen.
+ * mem_alloc och mem_free för block upp till 256 byte tas då från en
+ * fri-lista per tråd och storlek utan lås och utan anrop in i
+ * biblioteket; allt annat går den vanliga vägen. Cachen är knuten till
+ * poolens generation, så mem_deinit/mem_init gör den ogiltig.
+ * Länka mot libmemory_manager.a (med -flto) för att även få den
+ * trådlokala åtkomsten inline.
+ *
+ * Block i cachen är upptagna i poolens ögon. Det ger några luckor
+ * jämfört med mem_alloc/mem_free:
+ * - ett block som lämnas ut ur cachen räknas i histogrammets allocs
+ *   först när tråden tömmer cachen eller själv frågar efter histogrammet
+ *   (mem_flush_cache, mem_size_histogram, mem_deinit). live och
+ *   peak_live räknar blocket som levande hela tiden det ligger i cachen
+ * - blocken är smutsiga, och MM_BLOCK_ZEROED följer inte med dem.
+ *   mem_calloc tar aldrig ur cachen
+ * - ett block från mem_alloc_hint kan komma tillbaka ur cachen för en
+ *   vanlig allokering, utan sin placering
+ * - bara en direkt upprepad free av samma block upptäcks och ignoreras;
+ *   en dubbel free med andra block emellan korrumperar cachen
+ * - mem_pool_info läses atomiskt men utan lås, så en free som krockar med
+ *   mem_deinit/mem_init i en annan tråd är anroparens fel som vanligt
+ */
+
+// Layouten på blockheadern framför varje block
+struct mm_block_header {
+    size_t size;                    // antal bytes i datadelen
+    int    free;                    // 1 = fri, 0 = upptagen
+    int    flags;                   // MM_BLOCK_* nedan
+    struct mm_block_header *next;   // nästa block i listan
+};
+
+#define MM_BLOCK_ZEROED   0x1   // datadelen var noll när blocket lämnades ut
+#define MM_BLOCK_CARVED   0x2   // förskuret klassblock, går tillbaka till klasslistan
+#define MM_BLOCK_RESERVED 0x4   // oanvänd del av reserven för MM_HINT_HOT
+#define MM_BLOCK_ONLIST   0x8   // förskuret block som ligger fritt i klasslistan
+// bit 8 och uppåt: begärd storlek i histogrammet, se mm_size_hist
+
+#define MM_TCACHE_CLASSES 32   // 8..256 byte i steg om 8
+#define MM_TCACHE_MAX     64   // block per klass och tråd
+
+struct mm_pool_info {
+    unsigned long gen;     // räknas upp av mem_init och mem_deinit
+    uintptr_t     start;   // poolens gränser, 0 utan pool
+    uintptr_t     end;
+};
+
+struct mm_tcache {
+    unsigned long gen;                        // generationen blocken hör till
+    void         *head[MM_TCACHE_CLASSES];    // länken ligger i blockets data
+    unsigned      count[MM_TCACHE_CLASSES];
+    unsigned      allocs[MM_TCACHE_CLASSES * 8 + 1];   // utlämnade per begärd storlek, ej räknade än
+};
+
+extern struct mm_pool_info mm_pool_info;
+extern __thread struct mm_tcache mm_tcache;
+
+// Nollställer trådens cache för den aktuella poolen
+void mm_tcache_attach(void);
+
+static inline void *mem_alloc_inline(size_t size) {
+    size_t c = ((size + 7) >> 3) - 1;
+    if (size != 0 && c < MM_TCACHE_CLASSES &&
+        mm_tcache.gen == __atomic_load_n(&mm_pool_info.gen, __ATOMIC_ACQUIRE)) {
+        void *block = mm_tcache.head[c];
+        if (block) {
+            mm_tcache.head[c] = *(void **)block;
+            mm_tcache.count[c]--;
+            mm_tcache.allocs[size]++;
+            return block;
+        }
+    }
+    return mem_alloc(size);
+}
+
+static inline void mem_free_inline(void *block) {
+    uintptr_t p     = (uintptr_t)block;
+    uintptr_t start = __atomic_load_n(&mm_pool_info.start, __ATOMIC_RELAXED);
+    uintptr_t end   = __atomic_load_n(&mm_pool_info.end, __ATOMIC_RELAXED);
+    if (p - start < end - start) {
+        size_t c = (((struct mm_block_header *)block - 1)->size >> 3) - 1;
+        if (c < MM_TCACHE_CLASSES) {
+            if (mm_tcache.gen != __atomic_load_n(&mm_pool_info.gen, __ATOMIC_ACQUIRE)) mm_tcache_attach();
+            if (mm_tcache.head[c] == block) return;   // dubbel free, ligger redan i cachen
+            if (mm_tcache.count[c] < MM_TCACHE_MAX) {
+                *(void **)block = mm_tcache.head[c];
+                mm_tcache.head[c] = block;
+                mm_tcache.count[c]++;
+                return;
+            }
+        }
+    }
+    mem_free(block);
+}
+
+#ifdef MM_INLINE_FASTPATH
+#define mem_alloc(size)  mem_alloc_inline(size)
+#define mem_free(block)  mem_free_inline(block)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
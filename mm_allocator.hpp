@@ -0,0 +1,68 @@
+#ifndef MM_ALLOCATOR_HPP
+#define MM_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <limits>
+#include <new>           // för std::bad_alloc
+#include <type_traits>
+
+#include "memory_manager.h"
+
+namespace mm {
+
+// Allocator för standardcontainrar över poolen, t.ex.
+//   std::list<uint16_t, mm::allocator<uint16_t>> list;
+// Det finns bara en pool, så alla instanser är lika och utbytbara och
+// containrar kan flytta eller byta minne med varandra utan kopiering
+// (mem_init först)
+template <typename T>
+class allocator {
+public:
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using is_always_equal                        = std::true_type;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = allocator<U>;
+    };
+
+    allocator() noexcept = default;
+    template <typename U>
+    allocator(const allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        void* p = mem_alloc_aligned(n * sizeof(T), alignof(T));
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        mem_free_sized(p, n * sizeof(T));
+    }
+
+    std::size_t max_size() const noexcept {
+        return std::numeric_limits<std::size_t>::max() / sizeof(T);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const allocator<T>&, const allocator<U>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const allocator<T>&, const allocator<U>&) noexcept {
+    return false;
+}
+
+} // namespace mm
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef MM_BASIC_POOL_HPP
+#define MM_BASIC_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>       // för std::bad_alloc
+#include <thread>    // för std::this_thread::yield
+#include <type_traits>
+
+#include "memory_manager.h"
+
+namespace mm {
+
+// ---------------------------------------------------------------------
+// Storleksklasser. En klass-tabell har count, sizes och index(n), där
+// index(n) är första klassen >= n eller count om n är för stort
+// ---------------------------------------------------------------------
+
+namespace detail {
+
+constexpr std::size_t align8(std::size_t n) {
+    return (n + 7) & ~static_cast<std::size_t>(7);
+}
+
+// Uppslagstabell (n + 7) / 8 -> klass, så index(n) blir en enda läsning
+template <std::size_t Count, std::size_t Max>
+constexpr std::array<std::uint16_t, Max / 8 + 1> make_lookup(const std::array<std::size_t, Count>& sizes) {
+    std::array<std::uint16_t, Max / 8 + 1> lut{};
+    std::size_t cls = 0;
+    for (std::size_t i = 0; i < lut.size(); i++) {
+        while (sizes[cls] < i * 8) cls++;
+        lut[i] = static_cast<std::uint16_t>(cls);
+    }
+    return lut;
+}
+
+} // namespace detail
+
+// Klasser som växer med ungefär 1/Steps per steg från Min till Max,
+// avrundade till 8 byte: Steps = 4 ger högst ~25 % intern fragmentering
+template <std::size_t Min, std::size_t Max, std::size_t Steps = 4>
+struct geometric_classes {
+    static_assert(Min >= sizeof(void*) && Min <= Max, "Min must hold a freelist link");
+    static_assert(Steps > 0, "at least one step per doubling");
+
+private:
+    static constexpr std::size_t step(std::size_t s) {
+        std::size_t next = detail::align8(s + (s / Steps > 8 ? s / Steps : 8));
+        return next < Max ? next : Max;
+    }
+    static constexpr std::size_t count_classes() {
+        std::size_t n = 1;
+        for (std::size_t s = detail::align8(Min); s < Max; s = step(s)) n++;
+        return n;
+    }
+
+public:
+    static constexpr std::size_t count = count_classes();
+
+    static constexpr std::array<std::size_t, count> sizes = [] {
+        std::array<std::size_t, count> table{};
+        std::size_t s = detail::align8(Min);
+        for (std::size_t i = 0; i < count; i++, s = step(s)) table[i] = s < Max ? s : Max;
+        return table;
+    }();
+
+    static constexpr std::size_t index(std::size_t n) {
+        return n <= Max ? lookup[(n + 7) / 8] : count;
+    }
+
+private:
+    static constexpr auto lookup = detail::make_lookup<count, Max>(sizes);
+};
+
+// Uttryckligen angivna klasser, t.ex. explicit_classes<16, 24, 64, 256>
+template <std::size_t... Sizes>
+struct explicit_classes {
+    static constexpr std::size_t count = sizeof...(Sizes);
+    static constexpr std::array<std::size_t, count> sizes = {Sizes...};
+
+private:
+    static constexpr bool valid() {
+        for (std::size_t i = 0; i < count; i++) {
+            if (sizes[i] % 8 != 0 || sizes[i] < sizeof(void*)) return false;
+            if (i > 0 && sizes[i] <= sizes[i - 1]) return false;
+        }
+        return count > 0;
+    }
+    static_assert(valid(), "sizes must be increasing multiples of 8");
+
+    static constexpr std::size_t max_size = sizes[count - 1];
+    static constexpr auto lookup = detail::make_lookup<count, max_size>(sizes);
+
+public:
+    static constexpr std::size_t index(std::size_t n) {
+        return n <= max_size ? lookup[(n + 7) / 8] : count;
+    }
+};
+
+// ---------------------------------------------------------------------
+// Låspolicyer
+// ---------------------------------------------------------------------
+
+// Ingen synkronisering; poolen används av en enda tråd
+struct no_lock {
+    void lock() noexcept {}
+    void unlock() noexcept {}
+};
+
+struct mutex_lock {
+    void lock() { m.lock(); }
+    void unlock() { m.unlock(); }
+
+private:
+    std::mutex m;
+};
+
+// För korta kritiska sektioner; ger bort tidsluckan i stället för att snurra länge
+struct spin_lock {
+    void lock() noexcept {
+        for (int spins = 0; flag.test_and_set(std::memory_order_acquire); spins++)
+            if (spins >= 64) std::this_thread::yield();
+    }
+    void unlock() noexcept { flag.clear(std::memory_order_release); }
+
+private:
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+};
+
+// Varje tråd har egna fri-listor och går till den gemensamma (med mutex)
+// bara för att hämta eller lämna en hel sats. Trådens cache lämnas
+// tillbaka till poolens listor när tråden byter pool och när den avslutas
+struct per_thread {
+    static constexpr std::size_t batch = 32;
+};
+
+// ---------------------------------------------------------------------
+// Statistikpolicyer
+// ---------------------------------------------------------------------
+
+// Försvinner helt: tomma inline-funktioner och ingen storlek (tom bas)
+struct no_stats {
+    void on_alloc(std::size_t, std::size_t) noexcept {}
+    void on_free(std::size_t, std::size_t) noexcept {}
+    void on_refill(std::size_t) noexcept {}
+};
+
+struct counting_stats {
+    struct snapshot {
+        std::size_t allocs;
+        std::size_t frees;
+        std::size_t requested;   // begärda byte för levande block
+        std::size_t reserved;    // klassbyte för levande block
+        std::size_t refills;     // chunkar hämtade från minneshanteraren
+    };
+
+    void on_alloc(std::size_t requested, std::size_t reserved) noexcept {
+        allocs_.fetch_add(1, std::memory_order_relaxed);
+        requested_.fetch_add(requested, std::memory_order_relaxed);
+        reserved_.fetch_add(reserved, std::memory_order_relaxed);
+    }
+    void on_free(std::size_t requested, std::size_t reserved) noexcept {
+        frees_.fetch_add(1, std::memory_order_relaxed);
+        requested_.fetch_sub(requested, std::memory_order_relaxed);
+        reserved_.fetch_sub(reserved, std::memory_order_relaxed);
+    }
+    void on_refill(std::size_t) noexcept {
+        refills_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    snapshot totals() const noexcept {
+        return {allocs_.load(std::memory_order_relaxed), frees_.load(std::memory_order_relaxed),
+                requested_.load(std::memory_order_relaxed), reserved_.load(std::memory_order_relaxed),
+                refills_.load(std::memory_order_relaxed)};
+    }
+
+private:
+    std::atomic<std::size_t> allocs_{0}, frees_{0}, requested_{0}, reserved_{0}, refills_{0};
+};
+
+// ---------------------------------------------------------------------
+// Poolen
+// ---------------------------------------------------------------------
+
+// Allokator med storleksklasser ovanpå minneshanteraren. Block upp till
+// största klassen tas från fri-listor som fylls på med chunkar från
+// mem_alloc; större block går direkt till mem_alloc. deallocate behöver
+// samma storlek som allocate fick. Block är 8-byte-justerade som i
+// mem_alloc (mem_init först)
+template <typename SizeClasses, typename LockPolicy = mutex_lock, typename StatsPolicy = no_stats>
+class basic_pool : private StatsPolicy {
+    static constexpr bool thread_cached = std::is_same<LockPolicy, per_thread>::value;
+    using lock_type = std::conditional_t<thread_cached, mutex_lock, LockPolicy>;
+    static constexpr std::size_t classes = SizeClasses::count;
+    static constexpr std::size_t refill_bytes = 4096;
+
+    struct free_block {
+        free_block* next;
+    };
+    struct chunk {
+        chunk* next;
+    };
+
+public:
+    using size_classes = SizeClasses;
+    using stats_type   = StatsPolicy;
+
+    basic_pool() {
+        if constexpr (thread_cached) {
+            std::lock_guard<std::mutex> guard(live_lock_);
+            next_live_ = live_;
+            live_ = this;
+        }
+    }
+    basic_pool(const basic_pool&) = delete;
+    basic_pool& operator=(const basic_pool&) = delete;
+
+    // Lämnar alla chunkar till minneshanteraren; inga block får användas längre
+    ~basic_pool() {
+        if constexpr (thread_cached) {
+            // efter detta lämnar ingen tråd tillbaka sin cache hit
+            std::lock_guard<std::mutex> guard(live_lock_);
+            basic_pool** link = &live_;
+            while (*link != this) link = &(*link)->next_live_;
+            *link = next_live_;
+        }
+        while (chunks_) {
+            chunk* next = chunks_->next;
+            mem_free(chunks_);
+            chunks_ = next;
+        }
+    }
+
+    void* allocate(std::size_t n) {
+        std::size_t cls = SizeClasses::index(n);
+        if (cls == classes) {
+            void* p = mem_alloc(n);
+            if (!p) throw std::bad_alloc();
+            this->on_alloc(n, n);
+            return p;
+        }
+
+        free_block* b;
+        if constexpr (thread_cached) {
+            thread_cache& c = local_cache();
+            if (!c.head[cls]) fetch_batch(c, cls);
+            b = c.head[cls];
+            c.head[cls] = b->next;
+            c.count[cls]--;
+        } else {
+            std::lock_guard<lock_type> guard(lock_);
+            if (!lists_[cls]) refill(cls);
+            b = lists_[cls];
+            lists_[cls] = b->next;
+        }
+        this->on_alloc(n, SizeClasses::sizes[cls]);
+        return b;
+    }
+
+    void deallocate(void* p, std::size_t n) noexcept {
+        if (!p) return;
+        std::size_t cls = SizeClasses::index(n);
+        if (cls == classes) {
+            this->on_free(n, n);
+            mem_free_sized(p, n);
+            return;
+        }
+        this->on_free(n, SizeClasses::sizes[cls]);
+
+        free_block* b = static_cast<free_block*>(p);
+        if constexpr (thread_cached) {
+            thread_cache& c = local_cache();
+            b->next = c.head[cls];
+            c.head[cls] = b;
+            if (++c.count[cls] > 2 * per_thread::batch) return_batch(c, cls);
+        } else {
+            std::lock_guard<lock_type> guard(lock_);
+            b->next = lists_[cls];
+            lists_[cls] = b;
+        }
+    }
+
+    const StatsPolicy& stats() const noexcept { return *this; }
+
+private:
+    // Fyll på fri-listan för cls med en chunk (lock_ hålls)
+    void refill(std::size_t cls) {
+        std::size_t size  = SizeClasses::sizes[cls];
+        std::size_t slots = refill_bytes / size ? refill_bytes / size : 1;
+        void* mem = mem_alloc(sizeof(chunk) + slots * size);
+        if (!mem) throw std::bad_alloc();
+
+        chunk* c = static_cast<chunk*>(mem);
+        c->next = chunks_;
+        chunks_ = c;
+
+        char* base = static_cast<char*>(mem) + sizeof(chunk);
+        for (std::size_t i = slots; i-- > 0;) {
+            free_block* b = reinterpret_cast<free_block*>(base + i * size);
+            b->next = lists_[cls];
+            lists_[cls] = b;
+        }
+        this->on_refill(slots * size);
+    }
+
+    // Trådens cache, en per instansiering. owner är id för poolen blocken
+    // kom från; cachen lämnas tillbaka dit när tråden går över till en
+    // annan pool och när tråden avslutas
+    struct thread_cache {
+        std::uint64_t owner = 0;
+        free_block*   head[classes] = {};
+        std::size_t   count[classes] = {};
+
+        ~thread_cache() { give_back(*this); }
+    };
+
+    thread_cache& local_cache() {
+        static thread_local thread_cache cache;
+        if (cache.owner != id_) {
+            give_back(cache);
+            cache.owner = id_;
+        }
+        return cache;
+    }
+
+    // Lämnar cachen till poolen den kom från. Är poolen redan förstörd
+    // släpps blocken utan att röras; de gick till minneshanteraren med
+    // poolens chunkar
+    static void give_back(thread_cache& c) {
+        if (c.owner != 0) {
+            std::lock_guard<std::mutex> live(live_lock_);
+            for (basic_pool* p = live_; p; p = p->next_live_) {
+                if (p->id_ == c.owner) {
+                    p->take_cache(c);
+                    break;
+                }
+            }
+        }
+        c.owner = 0;
+        for (std::size_t cls = 0; cls < classes; cls++) {
+            c.head[cls]  = nullptr;
+            c.count[cls] = 0;
+        }
+    }
+
+    // Lägger en tråds hela cache först i fri-listorna (live_lock_ hålls)
+    void take_cache(thread_cache& c) {
+        std::lock_guard<lock_type> guard(lock_);
+        for (std::size_t cls = 0; cls < classes; cls++) {
+            if (!c.head[cls]) continue;
+            free_block* tail = c.head[cls];
+            while (tail->next) tail = tail->next;
+            tail->next  = lists_[cls];
+            lists_[cls] = c.head[cls];
+        }
+    }
+
+    void fetch_batch(thread_cache& c, std::size_t cls) {
+        std::lock_guard<lock_type> guard(lock_);
+        for (std::size_t i = 0; i < per_thread::batch; i++) {
+            if (!lists_[cls]) {
+                if (i > 0) break;
+                refill(cls);
+            }
+            free_block* b = lists_[cls];
+            lists_[cls] = b->next;
+            b->next = c.head[cls];
+            c.head[cls] = b;
+            c.count[cls]++;
+        }
+    }
+
+    void return_batch(thread_cache& c, std::size_t cls) {
+        std::lock_guard<lock_type> guard(lock_);
+        for (std::size_t i = 0; i < per_thread::batch; i++) {
+            free_block* b = c.head[cls];
+            c.head[cls] = b->next;
+            b->next = lists_[cls];
+            lists_[cls] = b;
+        }
+        c.count[cls] -= per_thread::batch;
+    }
+
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> ids{1};
+        return ids.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    free_block*   lists_[classes] = {};
+    chunk*        chunks_ = nullptr;
+    lock_type     lock_;
+    std::uint64_t id_ = thread_cached ? next_id() : 0;
+
+    // Levande pooler med trådcache, så att en cache bara lämnas tillbaka
+    // till en pool som finns kvar
+    basic_pool*                next_live_ = nullptr;
+    static inline std::mutex   live_lock_;
+    static inline basic_pool*  live_ = nullptr;
+};
+
+} // namespace mm
+
+#endif
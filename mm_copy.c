@@ -0,0 +1,184 @@
+#include "mm_copy.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MM_HAVE_NT 1
+#endif
+
+/*
+ * Icke-temporal kopiering:
+ * - målet justeras först med memcpy/memset till 32 byte, sedan skrivs
+ *   128 byte per varv med stream-instruktioner och resten med memcpy
+ * - sfence på slutet så att lagringarna är synliga innan blocket lämnas
+ *   över (de är svagt ordnade)
+ * - implementationen och standardtröskeln väljs en gång, med
+ *   __builtin_cpu_supports och sysconf
+ * - under sista cachenivåns storlek är en vanlig memcpy bättre: målet
+ *   ryms i cachen och läses ofta strax efteråt
+ */
+
+#define NT_UNSET 0   // standardtröskeln är inte vald än
+
+static _Atomic size_t nt_threshold = NT_UNSET;
+
+typedef void (*copy_fn)(void *dst, const void *src, size_t n);
+typedef void (*zero_fn)(void *dst, size_t n);
+
+static copy_fn        nt_copy = NULL;
+static zero_fn        nt_zero = NULL;
+static pthread_once_t nt_once = PTHREAD_ONCE_INIT;
+
+#ifdef MM_HAVE_NT
+
+// Antal byte fram till nästa 32-justerade adress
+static size_t head_bytes(void *dst, size_t n) {
+    size_t head = (32 - ((uintptr_t)dst & 31)) & 31;
+    return head < n ? head : n;
+}
+
+__attribute__((target("avx2")))
+static void copy_avx2(void *dst, const void *src, size_t n) {
+    size_t head = head_bytes(dst, n);
+    memcpy(dst, src, head);
+    char       *d = (char *)dst + head;
+    const char *s = (const char *)src + head;
+    n -= head;
+
+    for (; n >= 128; n -= 128, d += 128, s += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)s);
+        __m256i b = _mm256_loadu_si256((const __m256i *)(s + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(s + 64));
+        __m256i e = _mm256_loadu_si256((const __m256i *)(s + 96));
+        _mm256_stream_si256((__m256i *)d, a);
+        _mm256_stream_si256((__m256i *)(d + 32), b);
+        _mm256_stream_si256((__m256i *)(d + 64), c);
+        _mm256_stream_si256((__m256i *)(d + 96), e);
+    }
+    _mm_sfence();
+    memcpy(d, s, n);
+}
+
+__attribute__((target("avx2")))
+static void zero_avx2(void *dst, size_t n) {
+    size_t head = head_bytes(dst, n);
+    memset(dst, 0, head);
+    char *d = (char *)dst + head;
+    n -= head;
+
+    __m256i z = _mm256_setzero_si256();
+    for (; n >= 128; n -= 128, d += 128) {
+        _mm256_stream_si256((__m256i *)d, z);
+        _mm256_stream_si256((__m256i *)(d + 32), z);
+        _mm256_stream_si256((__m256i *)(d + 64), z);
+        _mm256_stream_si256((__m256i *)(d + 96), z);
+    }
+    _mm_sfence();
+    memset(d, 0, n);
+}
+
+__attribute__((target("sse2")))
+static void copy_sse2(void *dst, const void *src, size_t n) {
+    size_t head = head_bytes(dst, n);
+    memcpy(dst, src, head);
+    char       *d = (char *)dst + head;
+    const char *s = (const char *)src + head;
+    n -= head;
+
+    for (; n >= 64; n -= 64, d += 64, s += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i *)s);
+        __m128i b = _mm_loadu_si128((const __m128i *)(s + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(s + 32));
+        __m128i e = _mm_loadu_si128((const __m128i *)(s + 48));
+        _mm_stream_si128((__m128i *)d, a);
+        _mm_stream_si128((__m128i *)(d + 16), b);
+        _mm_stream_si128((__m128i *)(d + 32), c);
+        _mm_stream_si128((__m128i *)(d + 48), e);
+    }
+    _mm_sfence();
+    memcpy(d, s, n);
+}
+
+__attribute__((target("sse2")))
+static void zero_sse2(void *dst, size_t n) {
+    size_t head = head_bytes(dst, n);
+    memset(dst, 0, head);
+    char *d = (char *)dst + head;
+    n -= head;
+
+    __m128i z = _mm_setzero_si128();
+    for (; n >= 64; n -= 64, d += 64) {
+        _mm_stream_si128((__m128i *)d, z);
+        _mm_stream_si128((__m128i *)(d + 16), z);
+        _mm_stream_si128((__m128i *)(d + 32), z);
+        _mm_stream_si128((__m128i *)(d + 48), z);
+    }
+    _mm_sfence();
+    memset(d, 0, n);
+}
+
+#endif
+
+static void pick_nt(void) {
+    // sista cachenivån; utan känd storlek används inga stream-lagringar
+    long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (llc <= 0) {
+        llc = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    }
+    size_t unset = NT_UNSET;
+    atomic_compare_exchange_strong(&nt_threshold, &unset, llc > 0 ? (size_t)llc : SIZE_MAX);
+
+#ifdef MM_HAVE_NT
+    __builtin_cpu_init();   // kan köras före libgcc:s egen konstruktor
+    if (__builtin_cpu_supports("avx2")) {
+        nt_copy = copy_avx2;
+        nt_zero = zero_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        nt_copy = copy_sse2;
+        nt_zero = zero_sse2;
+    }
+#endif
+}
+
+// Tröskeln just nu; första anropet väljer standardvärdet
+static size_t threshold(void) {
+    size_t t = atomic_load_explicit(&nt_threshold, memory_order_relaxed);
+    if (t == NT_UNSET) {
+        pthread_once(&nt_once, pick_nt);
+        t = atomic_load_explicit(&nt_threshold, memory_order_relaxed);
+    }
+    return t;
+}
+
+void mm_copy(void *dst, const void *src, size_t n) {
+    if (n >= threshold()) {
+        pthread_once(&nt_once, pick_nt);
+        if (nt_copy) {
+            nt_copy(dst, src, n);
+            return;
+        }
+    }
+    memcpy(dst, src, n);
+}
+
+void mm_zero(void *dst, size_t n) {
+    if (n >= threshold()) {
+        pthread_once(&nt_once, pick_nt);
+        if (nt_zero) {
+            nt_zero(dst, n);
+            return;
+        }
+    }
+    memset(dst, 0, n);
+}
+
+size_t mm_set_nt_threshold(size_t bytes) {
+    // standardvärdet väljs först så att det inte skriver över bytes
+    pthread_once(&nt_once, pick_nt);
+    return atomic_exchange(&nt_threshold, bytes);
+}
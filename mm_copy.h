@@ -0,0 +1,26 @@
+#ifndef MM_COPY_H
+#define MM_COPY_H
+
+#include <stddef.h>   // för size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Kopiering och nollning för stora block i minneshanteraren. Över
+// tröskeln används icke-temporala lagringar (AVX2 eller SSE2, valt vid
+// körning) som går förbi cachen, så en stor flytt i mem_resize inte
+// tränger undan anroparens varma data; under den vanliga memcpy/memset.
+// Tröskeln är som standard storleken på sista cachenivån, så bara block
+// som ändå inte ryms där går förbi den; okänd cachestorlek stänger av
+void mm_copy(void* dst, const void* src, size_t n);
+void mm_zero(void* dst, size_t n);
+
+// Sätter tröskeln i byte (SIZE_MAX stänger av), returnerar den gamla
+size_t mm_set_nt_threshold(size_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
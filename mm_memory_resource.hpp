@@ -0,0 +1,40 @@
+#ifndef MM_MEMORY_RESOURCE_HPP
+#define MM_MEMORY_RESOURCE_HPP
+
+#include <memory_resource>
+#include <new>   // för std::bad_alloc
+
+#include "memory_manager.h"
+
+namespace mm {
+
+// std::pmr::memory_resource över poolen, så att pmr-containrar (och allt
+// de allokerar i sin tur) hamnar i poolen: mem_init först, sedan t.ex.
+//   std::pmr::vector<int> v(mm::pool_resource::instance());
+// Det finns bara en pool, så alla instanser är utbytbara och jämförs lika
+class pool_resource : public std::pmr::memory_resource {
+public:
+    static pool_resource* instance() {
+        static pool_resource resource;
+        return &resource;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = mem_alloc_aligned(bytes ? bytes : 1, alignment);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t) override {
+        mem_free_sized(p, bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return dynamic_cast<const pool_resource*>(&other) != nullptr;
+    }
+};
+
+} // namespace mm
+
+#endif
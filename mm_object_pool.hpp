@@ -0,0 +1,124 @@
+#ifndef MM_OBJECT_POOL_HPP
+#define MM_OBJECT_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>       // för std::bad_alloc
+#include <utility>   // för std::forward
+
+#include "memory_manager.h"
+
+namespace mm {
+
+// Typad objektpool: platser av exakt T:s storlek och justering tas från
+// minneshanteraren i chunkar om SlotsPerChunk och återanvänds via en
+// fri-lista, så make() är en listpop plus konstruktorn. Inte trådsäker;
+// en pool per tråd eller extern synkronisering (mem_init först)
+template <typename T, std::size_t SlotsPerChunk = 64>
+class object_pool {
+    static_assert(SlotsPerChunk > 0, "a chunk needs at least one slot");
+
+    struct free_slot {
+        free_slot* next;
+    };
+    struct chunk {
+        chunk* next;
+    };
+
+    static constexpr std::size_t round_up(std::size_t n, std::size_t align) {
+        return (n + align - 1) / align * align;
+    }
+    static constexpr std::size_t max(std::size_t a, std::size_t b) {
+        return a > b ? a : b;
+    }
+
+public:
+    // En plats rymmer T eller fri-listans länk, justerad för båda
+    static constexpr std::size_t slot_align = max(alignof(T), alignof(free_slot));
+    static constexpr std::size_t slot_size  = round_up(max(sizeof(T), sizeof(free_slot)), slot_align);
+
+    // Destruerar objektet och lägger tillbaka platsen i poolen
+    struct deleter {
+        object_pool* pool;
+        void operator()(T* p) const noexcept {
+            p->~T();
+            pool->deallocate(p);
+        }
+    };
+    using pointer = std::unique_ptr<T, deleter>;
+
+    object_pool() = default;
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    // Lämnar chunkarna till poolen; alla objekt ska redan vara borta
+    ~object_pool() {
+        while (chunks_) {
+            chunk* next = chunks_->next;
+            mem_free_sized(chunks_, chunk_bytes);
+            chunks_ = next;
+        }
+    }
+
+    // Konstruerar ett T av args på en ledig plats
+    template <typename... Args>
+    pointer make(Args&&... args) {
+        void* slot = allocate();
+        try {
+            return pointer(new (slot) T(std::forward<Args>(args)...), deleter{this});
+        } catch (...) {
+            deallocate(slot);
+            throw;
+        }
+    }
+
+    // Rå plats utan konstruktion; std::bad_alloc om poolen är slut
+    void* allocate() {
+        if (!free_) refill();
+        free_slot* slot = free_;
+        free_ = slot->next;
+        ++in_use_;
+        return slot;
+    }
+
+    void deallocate(void* p) noexcept {
+        free_slot* slot = static_cast<free_slot*>(p);
+        slot->next = free_;
+        free_ = slot;
+        --in_use_;
+    }
+
+    std::size_t in_use() const noexcept { return in_use_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    // chunk-headern tar en hel plats så att platserna behåller justeringen
+    static constexpr std::size_t header_bytes = round_up(sizeof(chunk), slot_align);
+    static constexpr std::size_t chunk_bytes  = header_bytes + SlotsPerChunk * slot_size;
+
+    void refill() {
+        void* mem = mem_alloc_aligned(chunk_bytes, slot_align);
+        if (!mem) throw std::bad_alloc();
+
+        chunk* c = static_cast<chunk*>(mem);
+        c->next = chunks_;
+        chunks_ = c;
+
+        char* base = static_cast<char*>(mem) + header_bytes;
+        for (std::size_t i = SlotsPerChunk; i-- > 0;) {
+            free_slot* slot = reinterpret_cast<free_slot*>(base + i * slot_size);
+            slot->next = free_;
+            free_ = slot;
+        }
+        capacity_ += SlotsPerChunk;
+    }
+
+    free_slot*  free_     = nullptr;
+    chunk*      chunks_   = nullptr;
+    std::size_t in_use_   = 0;
+    std::size_t capacity_ = 0;
+};
+
+} // namespace mm
+
+#endif
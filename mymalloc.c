@@ -0,0 +1,152 @@
+#include "memory_manager.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * malloc-familjen ovanpå minneshanteraren, för LD_PRELOAD:
+ *   LD_PRELOAD=./libmymalloc.so ./program
+ * - byggs med -DMM_USE_MMAP och -fvisibility=hidden, så poolen tas med
+ *   mmap och mem_*-symbolerna krockar inte med programmets egna
+ * - poolen skapas vid första anropet (MYMALLOC_POOL_SIZE byte, standard
+ *   64 MiB) och växer med mem_grow när den är full. MYMALLOC_PREFAULT=1
+ *   mappar in sidorna direkt (MAP_POPULATE, inga trådar)
+ * - malloc ska ge 16-justerade block. Varje header ligger 8 byte förbi en
+ *   16-gräns och alla storlekar är 16k + 8, så nästa header hamnar också
+ *   där; ett första block som aldrig frigörs justerar början av poolen
+ */
+
+#define EXPORT __attribute__((visibility("default")))
+
+#define DEFAULT_POOL_SIZE ((size_t)64 << 20)
+#define MIN_GROW_SIZE     ((size_t)64 << 20)
+
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+
+static void mymalloc_init(void) {
+    size_t size = DEFAULT_POOL_SIZE;
+    const char *env = getenv("MYMALLOC_POOL_SIZE");
+    if (env) {
+        size_t parsed = strtoull(env, NULL, 0);
+        if (parsed >= 4096) size = parsed;
+    }
+    struct mm_init_opts opts = {0, 0};
+    env = getenv("MYMALLOC_PREFAULT");
+    opts.prefault = env && *env == '1';
+    mem_init_opts(size, &opts);
+
+    // flyttar resten av poolen till 16-justerade headers (+8)
+    mem_alloc_aligned(8, 16);
+}
+
+// Minsta 16k + 8 som rymmer size
+static size_t block_size(size_t size) {
+    return size <= 8 ? 8 : ((size + 8 + 15) & ~(size_t)15) - 8;
+}
+
+static void *alloc_aligned(size_t size, size_t align) {
+    pthread_once(&init_once, mymalloc_init);
+    if (size > SIZE_MAX / 2) return NULL;
+
+    size_t req = block_size(size);
+    void *p = mem_alloc_aligned(req, align);
+    if (!p) {
+        // regionen behöver plats för headers och justering utöver blocket
+        size_t grow = req + align + 4096;
+        if (mem_grow(grow > MIN_GROW_SIZE ? grow : MIN_GROW_SIZE) == 0) {
+            p = mem_alloc_aligned(req, align);
+        }
+    }
+    return p;
+}
+
+EXPORT void *malloc(size_t size) {
+    void *p = alloc_aligned(size, 16);
+    if (!p) errno = ENOMEM;
+    return p;
+}
+
+EXPORT void free(void *ptr) {
+    mem_free(ptr);
+}
+
+EXPORT void *calloc(size_t n, size_t size) {
+    if (size && n > SIZE_MAX / size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    // inte via malloc: gcc gör om malloc + memset till ett calloc-anrop
+    void *p = alloc_aligned(n * size, 16);
+    if (!p) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    // nya regioner från mmap och stora frigjorda block är redan noll
+    if (!(((struct mm_block_header *)p - 1)->flags & MM_BLOCK_ZEROED)) {
+        memset(p, 0, n * size);
+    }
+    return p;
+}
+
+EXPORT void *realloc(void *ptr, size_t size) {
+    if (!ptr) return malloc(size);
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+
+    size_t old = mem_usable_size(ptr);
+    if (old == 0) {
+        // inte från poolen; storleken går inte att veta
+        errno = ENOMEM;
+        return NULL;
+    }
+    if (old >= size) return ptr;
+
+    // mem_resize växer på plats när nästa block är fritt, annars flyttar
+    // den med mem_alloc, som inte känner till poolens väg till mem_grow
+    void *p = mem_resize(ptr, block_size(size));
+    if (!p) {
+        p = malloc(size);
+        if (!p) return NULL;
+        memcpy(p, ptr, old);
+        free(ptr);
+    }
+    return p;
+}
+
+EXPORT int posix_memalign(void **out, size_t align, size_t size) {
+    if (align < sizeof(void *) || (align & (align - 1))) return EINVAL;
+    void *p = alloc_aligned(size, align < 16 ? 16 : align);
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+EXPORT void *aligned_alloc(size_t align, size_t size) {
+    if (align == 0 || (align & (align - 1))) {
+        errno = EINVAL;
+        return NULL;
+    }
+    void *p = alloc_aligned(size, align < 16 ? 16 : align);
+    if (!p) errno = ENOMEM;
+    return p;
+}
+
+EXPORT void *memalign(size_t align, size_t size) {
+    return aligned_alloc(align, size);
+}
+
+EXPORT void *valloc(size_t size) {
+    return aligned_alloc(4096, size);
+}
+
+EXPORT void *pvalloc(size_t size) {
+    return aligned_alloc(4096, (size + 4095) & ~(size_t)4095);
+}
+
+EXPORT size_t malloc_usable_size(void *ptr) {
+    return mem_usable_size(ptr);
+}
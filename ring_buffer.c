@@ -0,0 +1,249 @@
+#include "ring_buffer.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Ringbuffert i ett enda mem_alloc-block:
+ * - SPSC: producenten äger tail och konsumenten head, var på sin
+ *   cacherad. Båda håller en lokal kopia av den andras index och läser
+ *   det delade indexet bara när kopian säger full/tom
+ * - MPMC: Vyukovs kö, varje plats har ett sekvensnummer som säger om den
+ *   är ledig för varvet. Producenter och konsumenter tar positioner med
+ *   CAS och skriver/läser sedan platsen på plats
+ */
+#define CACHE_LINE 64
+#define ALIGN8(x) (((x) + 7) & ~(size_t)7)
+
+struct RingBuffer {
+    RingMode      mode;
+    size_t        mask;        // antal platser - 1
+    size_t        elem_size;
+    size_t        slot_size;   // MPMC: sekvensnummer + element
+    char          pad0[CACHE_LINE];
+
+    atomic_size_t tail;        // nästa position att skriva
+    size_t        cached_head; // producentens bild av head (SPSC)
+    char          pad1[CACHE_LINE];
+
+    atomic_size_t head;        // nästa position att läsa
+    size_t        cached_tail; // konsumentens bild av tail (SPSC)
+    char          pad2[CACHE_LINE];
+
+    unsigned char slots[];
+};
+
+static atomic_size_t *slot_seq(RingBuffer *ring, size_t pos) {
+    return (atomic_size_t *)(ring->slots + (pos & ring->mask) * ring->slot_size);
+}
+
+static unsigned char *slot_data(RingBuffer *ring, size_t pos) {
+    unsigned char *slot = ring->slots + (pos & ring->mask) * ring->slot_size;
+    return ring->mode == RING_MPMC ? slot + sizeof(atomic_size_t) : slot;
+}
+
+RingBuffer *ring_create(RingMode mode, size_t capacity, size_t elem_size) {
+    if (capacity == 0 || elem_size == 0) return NULL;
+
+    size_t slots = 1;
+    while (slots < capacity)
+        slots <<= 1;
+    size_t slot_size = mode == RING_MPMC ? sizeof(atomic_size_t) + ALIGN8(elem_size) : elem_size;
+
+    RingBuffer *ring = mem_alloc(sizeof(RingBuffer) + slots * slot_size);
+    if (!ring) return NULL;
+
+    ring->mode        = mode;
+    ring->mask        = slots - 1;
+    ring->elem_size   = elem_size;
+    ring->slot_size   = slot_size;
+    ring->cached_head = 0;
+    ring->cached_tail = 0;
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->head, 0);
+    if (mode == RING_MPMC)
+        for (size_t i = 0; i < slots; i++)
+            atomic_init(slot_seq(ring, i), i);   // ledig för varv 0
+    return ring;
+}
+
+void ring_destroy(RingBuffer *ring) {
+    mem_free(ring);
+}
+
+size_t ring_capacity(RingBuffer *ring) {
+    return ring->mask + 1;
+}
+
+// Kopierar count element mellan buffert och platser från pos, med omlindning
+static void copy_slots(RingBuffer *ring, size_t pos, void *elems, size_t count, int to_ring) {
+    size_t first = (pos & ring->mask);
+    size_t n1 = ring->mask + 1 - first;
+    if (n1 > count) n1 = count;
+    unsigned char *ring_part1 = ring->slots + first * ring->elem_size;
+    unsigned char *buf = elems;
+
+    if (to_ring) {
+        memcpy(ring_part1, buf, n1 * ring->elem_size);
+        memcpy(ring->slots, buf + n1 * ring->elem_size, (count - n1) * ring->elem_size);
+    } else {
+        memcpy(buf, ring_part1, n1 * ring->elem_size);
+        memcpy(buf + n1 * ring->elem_size, ring->slots, (count - n1) * ring->elem_size);
+    }
+}
+
+/* ---------- SPSC ---------- */
+
+static size_t spsc_free_from(RingBuffer *ring, size_t tail, size_t want) {
+    size_t capacity = ring->mask + 1;
+    if (capacity - (tail - ring->cached_head) < want)
+        ring->cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return capacity - (tail - ring->cached_head);
+}
+
+static size_t spsc_used_from(RingBuffer *ring, size_t head, size_t want) {
+    if (ring->cached_tail - head < want)
+        ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return ring->cached_tail - head;
+}
+
+static size_t spsc_push_batch(RingBuffer *ring, const void *elems, size_t count) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t free = spsc_free_from(ring, tail, count);
+    if (count > free) count = free;
+    if (count == 0) return 0;
+
+    copy_slots(ring, tail, (void *)elems, count, 1);
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+    return count;
+}
+
+static size_t spsc_pop_batch(RingBuffer *ring, void *elems, size_t count) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t used = spsc_used_from(ring, head, count);
+    if (count > used) count = used;
+    if (count == 0) return 0;
+
+    copy_slots(ring, head, elems, count, 0);
+    atomic_store_explicit(&ring->head, head + count, memory_order_release);
+    return count;
+}
+
+/* ---------- MPMC ---------- */
+
+// Tar upp till count lediga positioner i följd från *index. Returnerar
+// antalet och första positionen i *start. lap = 0 för skrivning, 1 för läsning
+static size_t mpmc_claim(RingBuffer *ring, atomic_size_t *index, size_t count, int lap, size_t *start) {
+    size_t pos = atomic_load_explicit(index, memory_order_relaxed);
+
+    for (;;) {
+        size_t n = 0;
+        while (n < count && n <= ring->mask) {
+            size_t seq = atomic_load_explicit(slot_seq(ring, pos + n), memory_order_acquire);
+            if (seq != pos + n + lap)
+                break;
+            n++;
+        }
+
+        if (n == 0) {
+            size_t seq = atomic_load_explicit(slot_seq(ring, pos), memory_order_acquire);
+            if ((intptr_t)(seq - (pos + lap)) < 0)
+                return 0;   // full (skrivning) eller tom (läsning)
+            pos = atomic_load_explicit(index, memory_order_relaxed);   // någon hann före
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(index, &pos, pos + n,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            *start = pos;
+            return n;
+        }
+    }
+}
+
+static size_t mpmc_push_batch(RingBuffer *ring, const void *elems, size_t count) {
+    size_t pos;
+    size_t n = mpmc_claim(ring, &ring->tail, count, 0, &pos);
+    const unsigned char *src = elems;
+
+    for (size_t i = 0; i < n; i++) {
+        memcpy(slot_data(ring, pos + i), src + i * ring->elem_size, ring->elem_size);
+        atomic_store_explicit(slot_seq(ring, pos + i), pos + i + 1, memory_order_release);
+    }
+    return n;
+}
+
+static size_t mpmc_pop_batch(RingBuffer *ring, void *elems, size_t count) {
+    size_t pos;
+    size_t n = mpmc_claim(ring, &ring->head, count, 1, &pos);
+    unsigned char *dst = elems;
+
+    for (size_t i = 0; i < n; i++) {
+        memcpy(dst + i * ring->elem_size, slot_data(ring, pos + i), ring->elem_size);
+        atomic_store_explicit(slot_seq(ring, pos + i), pos + i + ring->mask + 1, memory_order_release);
+    }
+    return n;
+}
+
+/* ---------- Gemensamt API ---------- */
+
+size_t ring_push_batch(RingBuffer *ring, const void *elems, size_t count) {
+    return ring->mode == RING_MPMC ? mpmc_push_batch(ring, elems, count)
+                                   : spsc_push_batch(ring, elems, count);
+}
+
+size_t ring_pop_batch(RingBuffer *ring, void *elems, size_t count) {
+    return ring->mode == RING_MPMC ? mpmc_pop_batch(ring, elems, count)
+                                   : spsc_pop_batch(ring, elems, count);
+}
+
+int ring_push(RingBuffer *ring, const void *elem) {
+    return ring_push_batch(ring, elem, 1) == 1;
+}
+
+int ring_pop(RingBuffer *ring, void *elem) {
+    return ring_pop_batch(ring, elem, 1) == 1;
+}
+
+void *ring_reserve(RingBuffer *ring, size_t *ticket) {
+    size_t pos;
+    if (ring->mode == RING_MPMC) {
+        if (mpmc_claim(ring, &ring->tail, 1, 0, &pos) == 0)
+            return NULL;
+    } else {
+        pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        if (spsc_free_from(ring, pos, 1) == 0)
+            return NULL;
+    }
+    *ticket = pos;
+    return slot_data(ring, pos);
+}
+
+void ring_commit(RingBuffer *ring, size_t ticket) {
+    if (ring->mode == RING_MPMC)
+        atomic_store_explicit(slot_seq(ring, ticket), ticket + 1, memory_order_release);
+    else
+        atomic_store_explicit(&ring->tail, ticket + 1, memory_order_release);
+}
+
+const void *ring_peek(RingBuffer *ring, size_t *ticket) {
+    size_t pos;
+    if (ring->mode == RING_MPMC) {
+        if (mpmc_claim(ring, &ring->head, 1, 1, &pos) == 0)
+            return NULL;
+    } else {
+        pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        if (spsc_used_from(ring, pos, 1) == 0)
+            return NULL;
+    }
+    *ticket = pos;
+    return slot_data(ring, pos);
+}
+
+void ring_release(RingBuffer *ring, size_t ticket) {
+    if (ring->mode == RING_MPMC)
+        atomic_store_explicit(slot_seq(ring, ticket), ticket + ring->mask + 1, memory_order_release);
+    else
+        atomic_store_explicit(&ring->head, ticket + 1, memory_order_release);
+}
@@ -0,0 +1,50 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stddef.h>   // för size_t
+#include "memory_manager.h"
+
+// Begränsad ringbuffert för meddelanden av fast storlek. Hela bufferten
+// (index och platser) är ett enda mem_alloc-block, så ett meddelande
+// kostar ingen allokering (mem_init först)
+typedef struct RingBuffer RingBuffer;
+
+typedef enum {
+    RING_SPSC,   // en producent och en konsument
+    RING_MPMC    // flera av båda
+} RingMode;
+
+// Skapar en buffert med plats för capacity element (avrundas uppåt till
+// en tvåpotens) om elem_size byte. NULL om minnet inte räcker
+RingBuffer* ring_create(RingMode mode, size_t capacity, size_t elem_size);
+
+// Frigör bufferten
+void ring_destroy(RingBuffer* ring);
+
+// Kopierar in ett element. Returnerar 1, eller 0 om bufferten är full
+int ring_push(RingBuffer* ring, const void* elem);
+
+// Kopierar ut ett element. Returnerar 1, eller 0 om bufferten är tom
+int ring_pop(RingBuffer* ring, void* elem);
+
+// Lägger in upp till count element i följd, returnerar hur många som fick plats
+size_t ring_push_batch(RingBuffer* ring, const void* elems, size_t count);
+
+// Tar ut upp till count element, returnerar hur många som fanns
+size_t ring_pop_batch(RingBuffer* ring, void* elems, size_t count);
+
+// Nollkopiering: reserverar nästa plats och ger en pekare att skriva
+// meddelandet direkt i, eller NULL om bufferten är full. Platsen blir
+// synlig för konsumenterna vid ring_commit med samma ticket
+void* ring_reserve(RingBuffer* ring, size_t* ticket);
+void  ring_commit(RingBuffer* ring, size_t ticket);
+
+// Nollkopiering för konsumenten: ger en pekare till nästa element, eller
+// NULL om bufferten är tom. Platsen återanvänds efter ring_release
+const void* ring_peek(RingBuffer* ring, size_t* ticket);
+void        ring_release(RingBuffer* ring, size_t ticket);
+
+// Antal platser
+size_t ring_capacity(RingBuffer* ring);
+
+#endif
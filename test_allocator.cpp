@@ -0,0 +1,165 @@
+#include "mm_allocator.hpp"
+#include "linked_list.h"
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <time.h>
+#include <vector>
+#include "common_defs.h"
+#include "gitdata.h"
+
+#define POOL_SIZE (4 * 1024 * 1024)
+
+// ********* Allocator requirements *********
+
+void test_allocator_containers(int count)
+{
+    printf_yellow("  Testing mm::allocator with std containers (elements: %d) ---> ", count);
+    mem_init(POOL_SIZE);
+    {
+        using IntAlloc = mm::allocator<int>;
+        using Traits = std::allocator_traits<IntAlloc>;
+        static_assert(Traits::is_always_equal::value, "one pool, all allocators equal");
+        static_assert(std::is_same<Traits::rebind_alloc<double>, mm::allocator<double>>::value, "rebind");
+        my_assert(IntAlloc() == mm::allocator<double>());
+
+        std::vector<int, IntAlloc> values;
+        for (int i = 0; i < count; i++)
+            values.push_back(i);
+        my_assert(values.size() == (size_t)count && values[count - 1] == count - 1);
+
+        // Node-based containers rebind to their internal node types
+        std::list<uint16_t, mm::allocator<uint16_t>> list(values.begin(), values.end());
+        my_assert(list.size() == (size_t)count && list.back() == (uint16_t)(count - 1));
+
+        using Key = std::basic_string<char, std::char_traits<char>, mm::allocator<char>>;
+        std::map<Key, int, std::less<Key>, mm::allocator<std::pair<const Key, int>>> map;
+        for (int i = 0; i < count; i++)
+            map[Key(40, 'a' + i % 26) + Key(std::to_string(i).c_str())] = i;
+        my_assert(map.size() == (size_t)count);
+
+        // Equal allocators let move assignment steal the buffer
+        std::vector<int, IntAlloc> other;
+        const int *data = values.data();
+        other = std::move(values);
+        my_assert(other.data() == data);
+    }
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Benchmark *********
+
+double elapsed_ms(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Appends count values, scans them and looks up every 16th, timing each
+// step for std::list on mm::allocator, std::list on std::allocator and
+// the C list in linked_list.c
+void bench_list_vs_std_list(int count, int rounds)
+{
+    printf_yellow("  Benchmarking lists (elements: %d, rounds: %d) ---> ", count, rounds);
+    mem_init(count * 128 + 64 * 1024);
+    struct timespec start, end;
+    double insert_ms[3], scan_ms[3], search_ms[3];
+    unsigned long sums[3] = {0, 0, 0};
+
+    auto run_std = [&](auto &list, int k)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < count; i++)
+            list.push_back(i);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        insert_ms[k] = elapsed_ms(&start, &end);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < rounds; r++)
+            for (uint16_t value : list)
+                sums[k] += value;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        scan_ms[k] = elapsed_ms(&start, &end) / rounds;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < count; i += 16)
+            sums[k] += *std::find(list.begin(), list.end(), (uint16_t)i);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        search_ms[k] = elapsed_ms(&start, &end);
+    };
+    {
+        std::list<uint16_t, mm::allocator<uint16_t>> pool_list;
+        run_std(pool_list, 0);
+    }
+    {
+        std::list<uint16_t> heap_list;
+        run_std(heap_list, 1);
+    }
+
+    Node *head = nullptr;
+    list_init(&head, 0); // pool is already initialized above
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        list_insert(&head, i);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    insert_ms[2] = elapsed_ms(&start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < rounds; r++)
+        for (Node *node = head; node; node = node->next)
+            sums[2] += node->data;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    scan_ms[2] = elapsed_ms(&start, &end) / rounds;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i += 16)
+        sums[2] += list_search(&head, i)->data;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    search_ms[2] = elapsed_ms(&start, &end);
+    list_cleanup(&head);
+
+    my_assert(sums[0] == sums[1] && sums[1] == sums[2]);
+    printf_green("[DONE].\n");
+    const char *names[3] = {"std::list + mm::allocator", "std::list + std::allocator", "linked_list.c"};
+    for (int k = 0; k < 3; k++)
+        printf("\t%-28s insert %.3f ms, scan %.3f ms, search %.3f ms\n", names[k], insert_ms[k], scan_ms[k], search_ms[k]);
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_allocator_containers - vector, list, map and strings on the pool\n");
+        printf(" 2. bench_list_vs_std_list [elements] - Compare std::list with the C list\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+    case 1:
+        test_allocator_containers(2000);
+        break;
+    case 2:
+        bench_list_vs_std_list(argc > 2 ? atoi(argv[2]) : 8192, 20);
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
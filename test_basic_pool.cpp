@@ -0,0 +1,159 @@
+#include "mm_basic_pool.hpp"
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "common_defs.h"
+#include "gitdata.h"
+
+#define POOL_SIZE (16 * 1024 * 1024)
+
+using Classes = mm::geometric_classes<16, 4096>;
+
+// The tables are built at compile time
+static_assert(Classes::sizes[0] == 16 && Classes::sizes[Classes::count - 1] == 4096, "range");
+static_assert(Classes::index(16) == 0 && Classes::index(17) == 1 && Classes::index(4097) == Classes::count, "lookup");
+static_assert(mm::explicit_classes<16, 64, 256>::index(65) == 2, "explicit lookup");
+
+// A single-threaded, stats-free pool carries nothing beyond its lists
+static_assert(sizeof(mm::basic_pool<Classes, mm::no_lock, mm::no_stats>) ==
+                  sizeof(mm::basic_pool<Classes, mm::no_lock, mm::counting_stats>) - sizeof(mm::counting_stats),
+              "no_stats costs no space");
+
+// Allocates and frees count blocks of mixed sizes, checking that no two
+// live blocks overlap (each is filled with its own pattern)
+template <typename Pool>
+void churn(Pool &pool, int count, unsigned seed)
+{
+    std::vector<std::pair<unsigned char *, size_t>> live;
+    for (int i = 0; i < count; i++)
+    {
+        size_t size = 1 + rand_r(&seed) % (i % 16 == 0 ? 8192 : 512);
+        unsigned char *p = static_cast<unsigned char *>(pool.allocate(size));
+        memset(p, (unsigned char)i, size);
+        live.push_back({p, size});
+        if (rand_r(&seed) % 3 == 0)
+        {
+            size_t k = rand_r(&seed) % live.size();
+            auto [q, n] = live[k];
+            my_assert(q[0] == q[n - 1] && q[n / 2] == q[0]);
+            pool.deallocate(q, n);
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+    for (auto [q, n] : live)
+    {
+        my_assert(q[0] == q[n - 1]);
+        pool.deallocate(q, n);
+    }
+}
+
+// ********* Policies *********
+
+template <typename Lock>
+void test_basic_pool(const char *name, int num_threads, int count)
+{
+    printf_yellow("  Testing basic_pool<%s> (threads: %d, operations: %d) ---> ", name, num_threads, count);
+    mem_init(POOL_SIZE);
+    {
+        mm::basic_pool<Classes, Lock, mm::counting_stats> pool;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++)
+            threads.emplace_back([&pool, count, t] { churn(pool, count, t + 1); });
+        for (auto &thread : threads)
+            thread.join();
+
+        auto totals = pool.stats().totals();
+        my_assert(totals.allocs == (size_t)num_threads * count);
+        my_assert(totals.frees == totals.allocs);
+        my_assert(totals.requested == 0 && totals.reserved == 0);
+        my_assert(totals.refills > 0);
+    }
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// A thread that alternates between two pools and then exits hands its cache
+// back each time, so neither pool needs more than its first chunk
+void test_thread_cache_handback()
+{
+    printf_yellow("  Testing per_thread cache hand-back on pool switch and thread exit ---> ");
+    mem_init(POOL_SIZE);
+    {
+        using Pool = mm::basic_pool<Classes, mm::per_thread, mm::counting_stats>;
+        Pool a, b;
+        std::thread worker([&a, &b] {
+            for (int i = 0; i < 10; i++)
+            {
+                a.deallocate(a.allocate(64), 64);
+                b.deallocate(b.allocate(64), 64);
+            }
+            a.allocate(64);   // the rest of the batch stays in the cache
+        });
+        worker.join();
+        my_assert(a.stats().totals().refills == 1 && b.stats().totals().refills == 1);
+
+        // The rest of the first chunk is back in the pool; one block is still live
+        size_t per_chunk = 4096 / Classes::sizes[Classes::index(64)];
+        std::vector<void *> blocks;
+        for (size_t i = 0; i + 1 < per_chunk; i++)
+            blocks.push_back(a.allocate(64));
+        my_assert(a.stats().totals().refills == 1);
+        for (void *p : blocks)
+            a.deallocate(p, 64);
+    }
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_basic_pool<no_lock> - Single-threaded pool\n");
+        printf(" 2. test_basic_pool<mutex_lock, spin_lock, per_thread> - Shared pools with various numbers of threads\n");
+        printf(" 3. test_thread_cache_handback - per_thread caches go back to their pool\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+    case 1:
+        test_basic_pool<mm::no_lock>("no_lock", 1, 20000);
+        if (atoi(argv[1]) == 1)
+            break;
+        // fall through
+    case 2:
+        for (int i = 0; i < 4; i++) // 1 to 8 threads
+        {
+            test_basic_pool<mm::mutex_lock>("mutex_lock", 1 << i, 5000);
+            test_basic_pool<mm::spin_lock>("spin_lock", 1 << i, 5000);
+            test_basic_pool<mm::per_thread>("per_thread", 1 << i, 5000);
+        }
+        if (atoi(argv[1]) == 2)
+            break;
+        // fall through
+    case 3:
+        test_thread_cache_handback();
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
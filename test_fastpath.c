@@ -0,0 +1,213 @@
+// Built with -DMM_INLINE_FASTPATH: mem_alloc/mem_free below are the inline
+// versions from memory_manager.h, (mem_alloc)/(mem_free) the library ones
+#include "memory_manager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include "common_defs.h"
+#include "gitdata.h"
+
+#define POOL_SIZE (1024 * 1024)
+
+// ********* Thread cache *********
+
+void test_fastpath_basic(void)
+{
+    printf_yellow("  Testing the inline thread cache ---> ");
+    mem_init(POOL_SIZE);
+
+    // A freed small block is the next one handed out for its size class
+    void *a = mem_alloc(40);
+    mem_free(a);
+    my_assert(mem_alloc(33) == a);
+    void *b = mem_alloc(40);
+    my_assert(b != a);
+    mem_free(b);
+
+    // Large blocks and mem_alloc(0) take the normal path
+    void *big = mem_alloc(4096);
+    mem_free(big);
+    my_assert(mem_alloc(4096) == big);
+    mem_free(big);
+    my_assert(mem_alloc(0) == mem_alloc(0));
+    mem_free(mem_alloc(0));
+
+    // Cached blocks stay allocated in the pool until flushed
+    mem_free(a);
+    my_assert(!pool_is_empty(POOL_SIZE));
+    mem_flush_cache();
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    // Overflowing a class sends the rest to mem_free
+    void *blocks[MM_TCACHE_MAX + 16];
+    for (int i = 0; i < MM_TCACHE_MAX + 16; i++)
+        blocks[i] = mem_alloc(16);
+    for (int i = 0; i < MM_TCACHE_MAX + 16; i++)
+        mem_free(blocks[i]);
+    my_assert(mm_tcache.count[1] == MM_TCACHE_MAX);
+    mem_flush_cache();
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    // Blocks handed out from the cache still reach the histogram
+    struct mm_size_hist *hist = malloc(sizeof(*hist));
+    a = mem_alloc(50);
+    mem_free(a);
+    my_assert(mem_alloc(50) == a);
+    mem_size_histogram(hist);
+    my_assert(hist->allocs[50] == 2);
+
+    // Freeing the same block twice in a row leaves one copy in the cache
+    mem_free(a);
+    mem_free(a);
+    my_assert(mm_tcache.count[6] == 1);
+    my_assert(mem_alloc(50) == a);
+    b = mem_alloc(50);
+    my_assert(b != a);
+    mem_free(a);
+    mem_free(b);
+    mem_flush_cache();
+    my_assert(pool_is_empty(POOL_SIZE));
+    free(hist);
+
+    // A new pool invalidates the cache without touching the old blocks
+    a = mem_alloc(24);
+    mem_free(a);
+    mem_deinit();
+    mem_init(POOL_SIZE);
+    b = mem_alloc(24);
+    my_assert(b != NULL);
+    mem_free(b);
+    mem_flush_cache();
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Threads free what they allocated into their own caches; the caches are
+// flushed back to the pool when the threads exit
+void *thread_fastpath_function(void *arg)
+{
+    void *blocks[256];
+    for (int round = 0; round < 100; round++)
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            blocks[i] = mem_alloc(8 + (i % 32) * 8);
+            memset(blocks[i], i, 8);
+        }
+        for (int i = 0; i < 256; i++)
+        {
+            my_assert(*(unsigned char *)blocks[i] == i);
+            mem_free(blocks[i]);
+        }
+    }
+    return NULL;
+}
+
+void test_fastpath_multithread(int num_threads)
+{
+    printf_yellow("  Testing thread caches with %d threads ---> ", num_threads);
+    mem_init(POOL_SIZE);
+
+    pthread_t threads[num_threads];
+    for (int i = 0; i < num_threads; i++)
+        pthread_create(&threads[i], NULL, thread_fastpath_function, NULL);
+    for (int i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Benchmark *********
+
+double elapsed_ms(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Alloc/free pairs of 32-byte blocks through the inline path and the library
+void bench_fastpath(int pairs)
+{
+    printf_yellow("  Benchmarking alloc/free pairs (pairs: %d) ---> ", pairs);
+    mem_init(POOL_SIZE);
+    struct timespec start, end;
+
+    // A few live blocks in front so the library path does some searching
+    void *live[64];
+    for (int i = 0; i < 64; i++)
+        live[i] = (mem_alloc)(32);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < pairs; i++)
+    {
+        void *volatile p = mem_alloc(32);
+        mem_free(p);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double inline_ms = elapsed_ms(&start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < pairs; i++)
+    {
+        void *volatile p = (mem_alloc)(32);
+        (mem_free)(p);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double library_ms = elapsed_ms(&start, &end);
+
+    for (int i = 0; i < 64; i++)
+        (mem_free)(live[i]);
+    mem_flush_cache();
+    mem_deinit();
+    printf_green("[DONE].\n");
+    printf("\tinline: %.1f ns, library: %.1f ns per pair\n", inline_ms * 1e6 / pairs, library_ms * 1e6 / pairs);
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_fastpath_basic - Reuse, overflow, flush and pool generations\n");
+        printf(" 2. test_fastpath_multithread - Per-thread caches flushed at thread exit\n");
+        printf(" 3. bench_fastpath [pairs] - Compare the inline path with the library call\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+        test_fastpath_basic();
+        for (int i = 0; i < 5; i++) // 1 to 16 threads
+            test_fastpath_multithread(pow(2, i));
+        break;
+    case 1:
+        test_fastpath_basic();
+        break;
+    case 2:
+        for (int i = 0; i < 5; i++)
+            test_fastpath_multithread(pow(2, i));
+        break;
+    case 3:
+        bench_fastpath(argc > 2 ? atoi(argv[2]) : 1000000);
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include "hash_map.h"
+#include "linked_list.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include "common_defs.h"
+#include "gitdata.h"
+
+typedef struct
+{
+    HashMap *map;
+    int thread_id;
+    int num_keys; // number of keys owned by this thread
+} thread_data_t;
+
+typedef struct
+{
+    int num_threads;
+    int num_keys;
+} TestParams;
+
+// ********* Basic operations *********
+
+void test_hash_map_basic(int count)
+{
+    printf_yellow("  Testing hash_map_put/get/remove and growth (keys: %d) ---> ", count);
+    mem_init(count * 128 + 64 * 1024);
+
+    HashMap *map = hash_map_create(0);
+    my_assert(map != NULL);
+    size_t initial_buckets = hash_map_buckets(map);
+
+    for (int i = 0; i < count; i++)
+        my_assert(hash_map_put(map, i, (void *)(uintptr_t)(i + 1)) == 0);
+    my_assert(hash_map_size(map) == (size_t)count);
+    my_assert(hash_map_buckets(map) > initial_buckets); // buckets were split incrementally
+
+    void *value = NULL;
+    for (int i = 0; i < count; i++)
+    {
+        my_assert(hash_map_get(map, i, &value) == 1);
+        my_assert((uintptr_t)value == (uintptr_t)(i + 1));
+    }
+    my_assert(hash_map_get(map, count, &value) == 0);
+
+    // Updating keeps the size
+    my_assert(hash_map_put(map, 0, (void *)(uintptr_t)42) == 0);
+    my_assert(hash_map_get(map, 0, &value) == 1 && (uintptr_t)value == 42);
+    my_assert(hash_map_size(map) == (size_t)count);
+
+    for (int i = 0; i < count; i += 2)
+        my_assert(hash_map_remove(map, i) == 1);
+    my_assert(hash_map_remove(map, 0) == 0);
+    my_assert(hash_map_size(map) == (size_t)count / 2);
+    for (int i = 0; i < count; i++)
+        my_assert(hash_map_get(map, i, NULL) == (i % 2));
+
+    hash_map_destroy(map);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Concurrency *********
+
+void *thread_hash_map_function(void *arg)
+{
+    thread_data_t *data = (thread_data_t *)arg;
+    uint32_t base = data->thread_id * data->num_keys;
+    void *value;
+
+    for (int i = 0; i < data->num_keys; i++)
+        my_assert(hash_map_put(data->map, base + i, (void *)(uintptr_t)(base + i)) == 0);
+    for (int i = 0; i < data->num_keys; i++)
+    {
+        my_assert(hash_map_get(data->map, base + i, &value) == 1);
+        my_assert((uintptr_t)value == base + i);
+    }
+    for (int i = 0; i < data->num_keys; i += 2)
+        my_assert(hash_map_remove(data->map, base + i) == 1);
+    return NULL;
+}
+
+void test_hash_map_multithread(TestParams *params)
+{
+    printf_yellow("  Testing hash map (threads: %d, keys: %d) ---> ", params->num_threads, params->num_keys);
+    mem_init(params->num_keys * 128 + 64 * 1024);
+
+    HashMap *map = hash_map_create(0);
+    pthread_t threads[params->num_threads];
+    thread_data_t thread_data[params->num_threads];
+    int keys_per_thread = params->num_keys / params->num_threads;
+
+    for (int i = 0; i < params->num_threads; i++)
+    {
+        thread_data[i].map = map;
+        thread_data[i].thread_id = i;
+        thread_data[i].num_keys = keys_per_thread;
+        pthread_create(&threads[i], NULL, thread_hash_map_function, &thread_data[i]);
+    }
+    for (int i = 0; i < params->num_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    my_assert(hash_map_size(map) == (size_t)(keys_per_thread - keys_per_thread / 2) * params->num_threads);
+    for (int i = 0; i < keys_per_thread * params->num_threads; i++)
+        my_assert(hash_map_get(map, i, NULL) == (i % keys_per_thread) % 2);
+
+    hash_map_destroy(map);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Benchmark *********
+
+double elapsed_ms(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Times the same lookups in the hash map and with list_search, both living in one pool
+void bench_hash_map_vs_list(int num_keys, int lookups)
+{
+    printf_yellow("  Benchmarking lookups (keys: %d, lookups: %d) ---> ", num_keys, lookups);
+    Node *head = NULL;
+    mem_init(num_keys * 192 + 64 * 1024);
+    list_init(&head, 0); // pool is already initialized above
+    HashMap *map = hash_map_create(0);
+
+    for (int i = 0; i < num_keys; i++)
+    {
+        hash_map_put(map, i, (void *)(uintptr_t)i);
+        list_insert(&head, i);
+    }
+
+    struct timespec start, end;
+    unsigned int seed = 1;
+    int found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < lookups; i++)
+        found += hash_map_get(map, rand_r(&seed) % num_keys, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double map_ms = elapsed_ms(&start, &end);
+    my_assert(found == lookups);
+
+    seed = 1;
+    found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < lookups; i++)
+        found += list_search(&head, rand_r(&seed) % num_keys) != NULL;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double list_ms = elapsed_ms(&start, &end);
+    my_assert(found == lookups);
+
+    hash_map_destroy(map);
+    list_cleanup(&head);
+    printf_green("[DONE].\n");
+    printf("\thash_map_get: %.3f us, list_search: %.3f us per lookup\n", map_ms * 1e3 / lookups, list_ms * 1e3 / lookups);
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_hash_map_basic - Put, get, remove and incremental growth\n");
+        printf(" 2. test_hash_map_multithread - Concurrent operations with various numbers of threads\n");
+        printf(" 3. bench_hash_map_vs_list [keys] - Compare lookups with list_search\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+        test_hash_map_basic(10000);
+        for (int i = 0; i < 9; i += 2) // 1, 4, 16, 64, 256 threads
+            test_hash_map_multithread(&(TestParams){.num_threads = pow(2, i), .num_keys = 16384});
+        break;
+    case 1:
+        test_hash_map_basic(10000);
+        break;
+    case 2:
+        for (int i = 0; i < 9; i++)
+            test_hash_map_multithread(&(TestParams){.num_threads = pow(2, i), .num_keys = 16384});
+        break;
+    case 3:
+        bench_hash_map_vs_list(argc > 2 ? atoi(argv[2]) : 4096, 20000);
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include "lf_queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <math.h>
+#include "common_defs.h"
+#include "gitdata.h"
+
+#define POOL_SIZE (1024 * 1024)
+
+typedef struct
+{
+    LfQueue *queue;
+    int thread_id;
+    int num_items;            // items produced by each producer
+    int num_producers;
+    atomic_int *consumed;     // total number of items dequeued
+    atomic_long *sum;         // sum of all dequeued items
+    int total;                // items the consumers should take in total
+} thread_data_t;
+
+typedef struct
+{
+    int num_producers;
+    int num_consumers;
+    int num_items;
+} TestParams;
+
+// The whole pool must be allocatable again, i.e. every node was reclaimed
+void assert_pool_empty()
+{
+    void *all = mem_alloc(POOL_SIZE / 2);
+    my_assert(all != NULL);
+    mem_free(all);
+}
+
+// ********* Basic FIFO behaviour *********
+
+void test_lf_queue_fifo(int count)
+{
+    printf_yellow("  Testing lf_queue FIFO order (items: %d) ---> ", count);
+    mem_init(POOL_SIZE);
+
+    LfQueue *queue = lf_queue_create();
+    my_assert(queue != NULL);
+
+    void *value = NULL;
+    my_assert(lf_queue_dequeue(queue, &value) == 0);
+    for (int i = 1; i <= count; i++)
+        my_assert(lf_queue_enqueue(queue, (void *)(uintptr_t)i) == 0);
+    for (int i = 1; i <= count; i++)
+    {
+        my_assert(lf_queue_dequeue(queue, &value) == 1);
+        my_assert((uintptr_t)value == (uintptr_t)i);
+    }
+    my_assert(lf_queue_dequeue(queue, &value) == 0);
+
+    // Leave some items behind, destroy must free them and the retired nodes
+    for (int i = 0; i < 10; i++)
+        lf_queue_enqueue(queue, NULL);
+    lf_queue_destroy(queue);
+    assert_pool_empty();
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Concurrency *********
+
+// Items are encoded as (producer << 20) | sequence
+void *thread_producer(void *arg)
+{
+    thread_data_t *data = (thread_data_t *)arg;
+    for (int i = 0; i < data->num_items; i++)
+        while (lf_queue_enqueue(data->queue, (void *)(uintptr_t)(((uintptr_t)data->thread_id << 20) | i)) != 0)
+            ; // pool temporarily full, consumers will make room
+    return NULL;
+}
+
+void *thread_consumer(void *arg)
+{
+    thread_data_t *data = (thread_data_t *)arg;
+    int last_seen[data->num_producers];
+    for (int i = 0; i < data->num_producers; i++)
+        last_seen[i] = -1;
+
+    while (atomic_load(data->consumed) < data->total)
+    {
+        void *value;
+        if (lf_queue_dequeue(data->queue, &value) != 1)
+            continue;
+        uintptr_t item = (uintptr_t)value;
+        int producer = item >> 20;
+        int sequence = item & ((1 << 20) - 1);
+        my_assert(sequence > last_seen[producer]); // FIFO per producer
+        last_seen[producer] = sequence;
+        atomic_fetch_add(data->sum, sequence);
+        atomic_fetch_add(data->consumed, 1);
+    }
+    return NULL;
+}
+
+void test_lf_queue_mpmc(TestParams *params)
+{
+    printf_yellow("  Testing lf_queue (producers: %d, consumers: %d, items: %d) ---> ", params->num_producers, params->num_consumers, params->num_items);
+    mem_init(POOL_SIZE);
+
+    LfQueue *queue = lf_queue_create();
+    atomic_int consumed = 0;
+    atomic_long sum = 0;
+    int threads_total = params->num_producers + params->num_consumers;
+    pthread_t threads[threads_total];
+    thread_data_t thread_data[threads_total];
+
+    for (int i = 0; i < threads_total; i++)
+    {
+        thread_data[i].queue = queue;
+        thread_data[i].thread_id = i;
+        thread_data[i].num_items = params->num_items;
+        thread_data[i].num_producers = params->num_producers;
+        thread_data[i].consumed = &consumed;
+        thread_data[i].sum = &sum;
+        thread_data[i].total = params->num_items * params->num_producers;
+        pthread_create(&threads[i], NULL, i < params->num_producers ? thread_producer : thread_consumer, &thread_data[i]);
+    }
+    for (int i = 0; i < threads_total; i++)
+        pthread_join(threads[i], NULL);
+
+    long expected = (long)params->num_producers * params->num_items * (params->num_items - 1) / 2;
+    my_assert(atomic_load(&consumed) == params->num_items * params->num_producers);
+    my_assert(atomic_load(&sum) == expected);
+
+    lf_queue_destroy(queue);
+    assert_pool_empty();
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_lf_queue_fifo - Single-threaded FIFO order and reclamation\n");
+        printf(" 2. test_lf_queue_mpmc - Concurrent producers and consumers\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+        test_lf_queue_fifo(10000);
+        for (int i = 0; i < 5; i++) // 1 to 16 producers and consumers
+            test_lf_queue_mpmc(&(TestParams){.num_producers = pow(2, i), .num_consumers = pow(2, i), .num_items = 4096});
+        break;
+    case 1:
+        test_lf_queue_fifo(10000);
+        break;
+    case 2:
+        for (int p = 0; p < 5; p++)
+            for (int c = 0; c < 5; c++)
+                test_lf_queue_mpmc(&(TestParams){.num_producers = pow(2, p), .num_consumers = pow(2, c), .num_items = 4096});
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
@@ -5,6 +5,8 @@
 #include <time.h>
 #include <stddef.h>
 #include <math.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 #include "common_defs.h"
 #include "gitdata.h"
 
@@ -519,6 +521,278 @@ void test_list_cleanup()
     printf_green("[PASS].\n");
 }
 
+// ********* Asynchronous operations *********
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    int completed;
+    int found;
+} async_counter_t;
+
+void async_count_callback(Node *result, void *arg)
+{
+    async_counter_t *counter = (async_counter_t *)arg;
+    pthread_mutex_lock(&counter->lock);
+    counter->completed++;
+    if (result)
+        counter->found++;
+    pthread_mutex_unlock(&counter->lock);
+}
+
+// Flushing from the worker must return instead of waiting on itself
+void async_flush_callback(Node *result, void *arg)
+{
+    (void)result;
+    list_async_flush();
+    async_count_callback(NULL, arg);
+}
+
+void test_list_async(int count)
+{
+    printf_yellow("  Testing list_*_async (nodes: %d) ---> ", count);
+    Node *head = NULL;
+    list_init(&head, (sizeof(Node) + 32) * count);
+
+    async_counter_t counter = {.completed = 0, .found = 0};
+    pthread_mutex_init(&counter.lock, NULL);
+    int efd = eventfd(0, 0);
+    list_async_set_eventfd(efd);
+
+    for (int i = 0; i < count; i++)
+        my_assert(list_insert_async(&head, i, async_count_callback, &counter) == 0);
+    for (int i = 0; i < count; i++)
+        my_assert(list_search_async(&head, i, async_count_callback, &counter) == 0);
+    list_async_flush();
+
+    my_assert(counter.completed == 2 * count);
+    my_assert(counter.found == count);
+    my_assert(list_count_nodes(&head) == count);
+
+    for (int i = 0; i < count; i++)
+        my_assert(list_delete_async(&head, i, NULL, NULL) == 0);
+    my_assert(list_search_async(&head, 0, async_flush_callback, &counter) == 0);
+    list_async_flush();
+    my_assert(head == NULL);
+    my_assert(counter.completed == 2 * count + 1);
+
+    uint64_t signalled = 0;
+    my_assert(read(efd, &signalled, sizeof(signalled)) == sizeof(signalled));
+    my_assert(signalled == 3 * (uint64_t)count + 1);
+
+    list_async_set_eventfd(-1);
+    close(efd);
+    pthread_mutex_destroy(&counter.lock);
+    list_cleanup(&head);
+    printf_green("[PASS].\n");
+}
+
+// ********* Snapshots *********
+
+typedef struct
+{
+    Node **head;
+    int count;
+} snapshot_writer_t;
+
+void *thread_snapshot_writer(void *arg)
+{
+    snapshot_writer_t *data = (snapshot_writer_t *)arg;
+    for (int i = 0; i < data->count; i++)
+        list_insert(data->head, i);
+    return NULL;
+}
+
+void test_list_snapshot(int count)
+{
+    printf_yellow("  Testing list_snapshot (nodes: %d) ---> ", count);
+    Node *head = NULL;
+    list_init(&head, (sizeof(Node) + 32) * count);
+    list_insert(&head, 1);
+    list_insert(&head, 2);
+
+    // Versions are shared until the list changes, and stay intact afterwards
+    ListSnapshot *first = list_snapshot(&head);
+    ListSnapshot *shared = list_snapshot(&head);
+    my_assert(first == shared);
+    list_snapshot_release(shared);
+
+    list_delete(&head, 1);
+    list_insert(&head, 3);
+    const uint16_t *values;
+    my_assert(list_snapshot_values(first, &values) == 2);
+    my_assert(values[0] == 1 && values[1] == 2);
+    list_snapshot_release(first);
+
+    list_delete(&head, 2);
+    list_delete(&head, 3);
+
+    // Every snapshot taken while a writer appends 0, 1, 2, ... must be a prefix of that sequence
+    pthread_t writer;
+    snapshot_writer_t writer_data = {.head = &head, .count = count};
+    pthread_create(&writer, NULL, thread_snapshot_writer, &writer_data);
+
+    size_t last = 0;
+    while (last < (size_t)count)
+    {
+        ListSnapshot *snap = list_snapshot(&head);
+        size_t n = list_snapshot_values(snap, &values);
+        my_assert(n >= last);
+        for (size_t i = 0; i < n; i++)
+            my_assert(values[i] == i);
+        last = n;
+        list_snapshot_release(snap);
+    }
+    pthread_join(writer, NULL);
+
+    list_cleanup(&head);
+    printf_green("[PASS].\n");
+}
+
+// ********* Splice, split and concat *********
+
+void assert_list_values(Node *head, const uint16_t *expected, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        my_assert(head != NULL && head->data == expected[i]);
+        if (!head)
+            return;
+        head = head->next;
+    }
+    my_assert(head == NULL);
+}
+
+void *thread_concat_function(void *arg)
+{
+    thread_data_t *data = (thread_data_t *)arg;
+    Node *local = NULL;
+    for (int i = 0; i < data->num_nodes; i++)
+        list_insert(&local, data->start_value + i);
+    list_concat(data->head, &local); // hand the whole batch over at once
+    my_assert(local == NULL);
+    return NULL;
+}
+
+void test_list_splice(TestParams *params)
+{
+    printf_yellow("  Testing list_splice/list_split_at/list_concat (threads: %d, nodes: %d) ---> ", params->num_threads, params->num_nodes);
+    Node *a = NULL;
+    Node *b = NULL;
+    Node *rest = NULL;
+    list_init(&a, (sizeof(Node) + 32) * (params->num_nodes + 8));
+
+    for (int i = 1; i <= 5; i++)
+        list_insert(&a, i);
+    for (int i = 6; i <= 8; i++)
+        list_insert(&b, i);
+
+    list_concat(&a, &b);
+    my_assert(b == NULL);
+    assert_list_values(a, (uint16_t[]){1, 2, 3, 4, 5, 6, 7, 8}, 8);
+
+    list_split_at(&a, list_search(&a, 4), &rest);
+    assert_list_values(a, (uint16_t[]){1, 2, 3, 4}, 4);
+    assert_list_values(rest, (uint16_t[]){5, 6, 7, 8}, 4);
+
+    list_splice(&a, list_search(&a, 2), &rest);
+    my_assert(rest == NULL);
+    list_insert(&a, 9); // tail must have followed the splice
+    list_insert(&rest, 10);
+    assert_list_values(a, (uint16_t[]){1, 2, 5, 6, 7, 8, 3, 4, 9}, 9);
+
+    list_splice(&a, NULL, &rest);
+    list_split_at(&a, NULL, &b);
+    my_assert(a == NULL);
+    assert_list_values(b, (uint16_t[]){10, 1, 2, 5, 6, 7, 8, 3, 4, 9}, 10);
+    list_concat(&a, &b);
+
+    // Concurrent handoffs of whole batches into one list
+    pthread_t threads[params->num_threads];
+    thread_data_t thread_data[params->num_threads];
+    int nodes_per_thread = params->num_nodes / params->num_threads;
+    for (int i = 0; i < params->num_threads; i++)
+    {
+        thread_data[i].head = &a;
+        thread_data[i].start_value = 100 + i * nodes_per_thread;
+        thread_data[i].num_nodes = nodes_per_thread;
+        pthread_create(&threads[i], NULL, thread_concat_function, &thread_data[i]);
+    }
+    for (int i = 0; i < params->num_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    my_assert(list_count_nodes(&a) == 10 + nodes_per_thread * params->num_threads);
+
+    list_cleanup(&a);
+    printf_green("[PASS].\n");
+}
+
+// ********* Range output and value-range queries *********
+
+void test_list_query_range(int count)
+{
+    printf_yellow("  Testing list_format_range/list_query_range (nodes: %d) ---> ", count);
+    Node *head = NULL;
+    list_init(&head, (sizeof(Node) + 32) * (count + 20));
+
+    int values[count + 20];
+    for (int i = count; i < count + 20; i++)
+        values[i] = -1;
+    for (int i = 0; i < count; i++)
+    {
+        values[i] = rand() % 1000;
+        list_insert(&head, values[i]);
+    }
+
+    char buffer[64];
+    Node *third = head->next->next;
+    size_t len = list_format_range(&head, third, third->next, buffer, sizeof(buffer));
+    char expected[64];
+    snprintf(expected, sizeof(expected), "[%d, %d]\n", values[2], values[3]);
+    my_assert(strcmp(buffer, expected) == 0);
+    my_assert(len == strlen(expected));
+
+    char printed[64] = {0};
+    capture_stdout(printed, sizeof(printed), (void (*)(Node **, Node *, Node *))list_display_range, &head, third, third->next);
+    my_assert(strcmp(printed, expected) == 0);
+
+    // Too small a buffer is truncated but still reports the full length
+    char tiny[4];
+    len = list_format_range(&head, NULL, NULL, tiny, sizeof(tiny));
+    my_assert(strlen(tiny) == sizeof(tiny) - 1);
+    my_assert(len > sizeof(tiny));
+
+    Node **out = malloc((count + 20) * sizeof(Node *));
+    for (int round = 0; round < 20; round++)
+    {
+        uint16_t lo = rand() % 1000;
+        uint16_t hi = lo + rand() % 200;
+        int expected_hits = 0;
+        for (int i = 0; i < count + 20; i++)
+            if (values[i] >= lo && values[i] <= hi)
+                expected_hits++;
+
+        size_t hits = list_query_range(&head, lo, hi, out, count + 20);
+        my_assert(hits == (size_t)expected_hits);
+        for (size_t i = 0; i < hits; i++)
+        {
+            my_assert(out[i]->data >= lo && out[i]->data <= hi);
+            if (i > 0)
+                my_assert(out[i - 1]->data <= out[i]->data);
+        }
+
+        // The index must follow changes to the list
+        list_delete(&head, values[round]);
+        values[round] = -1;
+        values[count + round] = rand() % 1000;
+        list_insert(&head, values[count + round]);
+    }
+    free(out);
+
+    list_cleanup(&head);
+    printf_green("[PASS].\n");
+}
+
 // ********* Stress and edge cases *********
 
 void test_list_insert_loop(int count)
@@ -644,6 +918,53 @@ void test_list_edge_cases()
     printf_green("[PASS].\n");
 }
 
+// ********* Benchmarks *********
+
+double elapsed_ms(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Builds a list whose node order is unrelated to the address order in the pool,
+// then times full traversals. Build with -DLIST_NO_PREFETCH (make test_list_noprefetch) for the baseline.
+void bench_list_traversal(int num_nodes, int rounds)
+{
+    printf_yellow("  Benchmarking traversal (nodes: %d, rounds: %d) ---> ", num_nodes, rounds);
+    Node *head = NULL;
+    list_init(&head, (sizeof(Node) + 64) * num_nodes);
+
+    Node **nodes = malloc(num_nodes * sizeof(Node *));
+    list_insert(&head, 0);
+    nodes[0] = head;
+    for (int i = 1; i < num_nodes; i++)
+    {
+        Node *prev = nodes[rand() % i];
+        list_insert_after(prev, i % 65000);
+        nodes[i] = prev->next;
+    }
+    free(nodes);
+
+    struct timespec start, end;
+    int count = list_count_nodes(&head); // first pass records jump pointers
+    my_assert(count == num_nodes);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < rounds; r++)
+        my_assert(list_count_nodes(&head) == num_nodes);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double count_ms = elapsed_ms(&start, &end) / rounds;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < rounds; r++)
+        my_assert(list_search(&head, 65535) == NULL); // never inserted, walks the whole list
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double search_ms = elapsed_ms(&start, &end) / rounds;
+
+    list_cleanup(&head);
+    printf_green("[DONE].\n");
+    printf("\tlist_count_nodes: %.2f ms, list_search (miss): %.2f ms per traversal\n", count_ms, search_ms);
+}
+
 // Main function to run all tests
 int main(int argc, char *argv[])
 {
@@ -670,6 +991,13 @@ int main(int argc, char *argv[])
         printf(" 6. test_list_insert_after - Test multiple insertions after a given node\n");
         printf(" 7. test_list_insert_after - Test multiple insertions after a given node\n");
         printf(" 8. test_list_delete - Test multiple detelions\n");
+        printf(" 9. bench_list_traversal [nodes] - Time traversals of a large, shuffled list\n");
+        printf("10. test_flat_combining - Basic operations with flat combining enabled\n");
+        printf("11. test_delegate - Basic operations routed through the list server thread\n");
+        printf("12. test_list_async - Asynchronous insert/search/delete with callbacks and eventfd\n");
+        printf("13. test_list_snapshot - Snapshots stay consistent while a writer keeps going\n");
+        printf("14. test_list_splice - Splice, split and concat, and concurrent batch handoff\n");
+        printf("15. test_list_query_range - Range output to stdout and buffers, value-range queries\n");
         printf(" 0. Run all tests\n");
         return 1;
     }
@@ -729,6 +1057,42 @@ int main(int argc, char *argv[])
             for (int j = 8; j < 14; j++) // from 2^8 = 256 up to 2^14 = 16384 nodes
                 test_list_delete_multithreaded(&(TestParams){.num_threads = pow(2, i), .num_nodes = pow(2, j)});
         break;
+    case 9:
+        bench_list_traversal(argc > 2 ? atoi(argv[2]) : 1 << 16, 20);
+        break;
+    case 10:
+        printf("Testing Basic Operations with flat combining:\n");
+        list_set_flat_combining(1);
+        for (int i = 0; i < 9; i += 2) // 1, 4, 16, 64, 256 threads
+        {
+            test_list_insert_multithread(&(TestParams){.num_threads = pow(2, i), .num_nodes = 1024});
+            test_list_delete_multithreaded(&(TestParams){.num_threads = pow(2, i), .num_nodes = 1024});
+        }
+        list_set_flat_combining(0);
+        break;
+    case 11:
+        printf("Testing Basic Operations through the delegate thread:\n");
+        my_assert(list_delegate_start() == 0);
+        for (int i = 0; i < 9; i += 2) // 1, 4, 16, 64, 256 threads
+        {
+            test_list_insert_multithread(&(TestParams){.num_threads = pow(2, i), .num_nodes = 1024});
+            test_list_delete_multithreaded(&(TestParams){.num_threads = pow(2, i), .num_nodes = 1024});
+        }
+        list_delegate_stop();
+        break;
+    case 12:
+        test_list_async(1024);
+        break;
+    case 13:
+        test_list_snapshot(4096);
+        break;
+    case 14:
+        for (int i = 0; i < 9; i += 2) // 1, 4, 16, 64, 256 threads
+            test_list_splice(&(TestParams){.num_threads = pow(2, i), .num_nodes = 1024});
+        break;
+    case 15:
+        test_list_query_range(1024);
+        break;
 
     default:
         printf("Invalid test function\n");
@@ -0,0 +1,172 @@
+#include "lru_cache.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include "common_defs.h"
+#include "gitdata.h"
+
+typedef struct
+{
+    LruCache *cache;
+    int thread_id;
+    int num_keys;   // keys are drawn from [0, num_keys)
+    int operations; // number of get/put operations per thread
+} thread_data_t;
+
+typedef struct
+{
+    int num_threads;
+    int capacity;
+    int num_shards;
+} TestParams;
+
+// ********* Basic LRU behaviour *********
+
+void count_evictions(uint32_t key, void *value, void *arg)
+{
+    (void)key;
+    (void)value;
+    (*(int *)arg)++;
+}
+
+void test_lru_basic()
+{
+    printf_yellow("  Testing lru_get/lru_put/eviction order ---> ");
+    mem_init(64 * 1024);
+
+    int evicted = 0;
+    LruCache *cache = lru_create(3, 1, count_evictions, &evicted);
+    my_assert(cache != NULL);
+
+    void *value = NULL;
+    my_assert(lru_get(cache, 1, &value) == 0);
+    lru_put(cache, 1, (void *)(uintptr_t)10);
+    lru_put(cache, 2, (void *)(uintptr_t)20);
+    lru_put(cache, 3, (void *)(uintptr_t)30);
+
+    // Touch 1 so that 2 becomes least recently used
+    my_assert(lru_get(cache, 1, &value) == 1);
+    my_assert((uintptr_t)value == 10);
+
+    lru_put(cache, 4, (void *)(uintptr_t)40);
+    my_assert(evicted == 1);
+    my_assert(lru_get(cache, 2, &value) == 0);
+    my_assert(lru_get(cache, 3, &value) == 1);
+    my_assert(lru_get(cache, 4, &value) == 1 && (uintptr_t)value == 40);
+
+    // Updating an existing key does not evict
+    lru_put(cache, 3, (void *)(uintptr_t)33);
+    my_assert(evicted == 1);
+    my_assert(lru_get(cache, 3, &value) == 1 && (uintptr_t)value == 33);
+
+    my_assert(lru_remove(cache, 3) == 1);
+    my_assert(lru_remove(cache, 3) == 0);
+
+    LruStats stats;
+    lru_get_stats(cache, &stats);
+    my_assert(stats.hits == 4);
+    my_assert(stats.misses == 2);
+    my_assert(stats.evictions == 1);
+    my_assert(stats.size == 2);
+
+    lru_destroy(cache);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Concurrency *********
+
+void *thread_lru_function(void *arg)
+{
+    thread_data_t *data = (thread_data_t *)arg;
+    unsigned int seed = data->thread_id;
+    for (int i = 0; i < data->operations; i++)
+    {
+        uint32_t key = rand_r(&seed) % data->num_keys;
+        void *value = NULL;
+        if (lru_get(data->cache, key, &value))
+            my_assert((uintptr_t)value == key * 2); // values are always derived from their key
+        else
+            my_assert(lru_put(data->cache, key, (void *)(uintptr_t)(key * 2)) == 0);
+    }
+    return NULL;
+}
+
+void test_lru_multithread(TestParams *params)
+{
+    printf_yellow("  Testing LRU cache (threads: %d, capacity: %d, shards: %d) ---> ", params->num_threads, params->capacity, params->num_shards);
+    mem_init(params->capacity * 128 + 64 * 1024);
+
+    LruCache *cache = lru_create(params->capacity, params->num_shards, NULL, NULL);
+    my_assert(cache != NULL);
+
+    pthread_t threads[params->num_threads];
+    thread_data_t thread_data[params->num_threads];
+    int operations = 20000 / params->num_threads;
+    for (int i = 0; i < params->num_threads; i++)
+    {
+        thread_data[i].cache = cache;
+        thread_data[i].thread_id = i;
+        thread_data[i].num_keys = params->capacity * 2;
+        thread_data[i].operations = operations;
+        pthread_create(&threads[i], NULL, thread_lru_function, &thread_data[i]);
+    }
+    for (int i = 0; i < params->num_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    LruStats stats;
+    lru_get_stats(cache, &stats);
+    my_assert(stats.hits + stats.misses == (unsigned long)operations * params->num_threads);
+    my_assert(stats.size <= (size_t)params->capacity + params->num_shards); // per-shard capacity is rounded up
+    // Two threads can miss on the same key; the second put only updates it
+    my_assert(stats.size + stats.evictions <= stats.misses);
+    if (params->num_threads == 1)
+        my_assert(stats.size + stats.evictions == stats.misses);
+
+    lru_destroy(cache);
+    mem_deinit();
+    printf_green("[PASS].\n");
+    printf("\thits: %lu, misses: %lu, evictions: %lu\n", stats.hits, stats.misses, stats.evictions);
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_lru_basic - Hits, misses and eviction order in a single shard\n");
+        printf(" 2. test_lru_multithread - Concurrent get/put with various numbers of threads and shards\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+        test_lru_basic();
+        for (int i = 0; i < 9; i += 2) // 1, 4, 16, 64, 256 threads
+            test_lru_multithread(&(TestParams){.num_threads = pow(2, i), .capacity = 1024, .num_shards = 16});
+        break;
+    case 1:
+        test_lru_basic();
+        break;
+    case 2:
+        for (int i = 0; i < 9; i += 2)
+            for (int shards = 1; shards <= 64; shards *= 4)
+                test_lru_multithread(&(TestParams){.num_threads = pow(2, i), .capacity = 1024, .num_shards = shards});
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
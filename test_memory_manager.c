@@ -12,6 +12,7 @@
 #include <sys/mman.h>
 #include <fcntl.h>
 #include "common_defs.h"
+#include "mm_copy.h"
 
 #include <unistd.h>
 
@@ -887,6 +888,584 @@ void test_looking_for_out_of_bounds()
     printf("[PASS].\n");
 }
 
+// Returns true if all size bytes at p are zero
+static bool all_zero(const unsigned char *p, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        if (p[i])
+            return false;
+    return true;
+}
+
+void test_calloc_zeroed()
+{
+    printf_yellow("  Testing mem_calloc on fresh, reused and returned memory ---> ");
+    mem_init(4 * 1024 * 1024);
+
+    unsigned char *fresh = mem_calloc(1000, 1000);
+    my_assert(fresh != NULL && all_zero(fresh, 1000 * 1000));
+    memset(fresh, 0xAB, 1000 * 1000);
+
+    // Small dirty blocks are reused and must be cleared
+    unsigned char *dirty = mem_alloc(1000);
+    memset(dirty, 0xFF, 1000);
+    mem_free(dirty);
+    unsigned char *small = mem_calloc(10, 100);
+    my_assert(small == dirty);
+    my_assert(all_zero(small, 1000));
+    mem_free(small);
+
+    // A large dirty block is reused and still comes back zeroed
+    mem_free(fresh);
+    unsigned char *again = mem_calloc(1, 1000 * 1000);
+    my_assert(again == fresh);
+    my_assert(all_zero(again, 1000 * 1000));
+    mem_free(again);
+
+    // Large free blocks go back to the OS only after many freed bytes
+    struct mm_stats stats;
+    mem_stats(&stats);
+    my_assert(stats.trimmed_bytes == 0);
+    for (int i = 0; i < 20; i++)
+    {
+        unsigned char *big = mem_alloc(1000 * 1000);
+        memset(big, 0xCD, 1000 * 1000);
+        mem_free(big);
+    }
+    mem_stats(&stats);
+    my_assert(stats.trimmed_bytes >= 1000 * 1000);
+    again = mem_calloc(1, 1000 * 1000);
+    my_assert(all_zero(again, 1000 * 1000));
+    mem_free(again);
+
+    // Overflow and empty requests
+    volatile size_t too_many = SIZE_MAX / 2;
+    my_assert(mem_calloc(too_many, 4) == NULL);
+    my_assert(mem_calloc(0, 16) != NULL);
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+double elapsed_ms(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Zeroed buffer on a fresh pool: mem_calloc against mem_alloc + memset
+void bench_calloc_fresh(size_t size)
+{
+    printf_yellow("  Benchmarking zeroed allocation on a fresh pool (%zu MiB) ---> ", size >> 20);
+    struct timespec start, end;
+
+    mem_init(size + 4096);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    void *p = mem_alloc(size);
+    memset(p, 0, size);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double memset_ms = elapsed_ms(&start, &end);
+    mem_deinit();
+
+    mem_init(size + 4096);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    p = mem_calloc(1, size);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double calloc_ms = elapsed_ms(&start, &end);
+    my_assert(p != NULL && ((unsigned char *)p)[size / 2] == 0);
+    mem_deinit();
+
+    printf_green("[DONE].\n");
+    printf("\tmem_alloc + memset: %.3f ms, mem_calloc: %.3f ms\n", memset_ms, calloc_ms);
+}
+
+// Sums a buffer; used as the caller's hot working set
+static unsigned long scan_hot(const unsigned long *hot, size_t count)
+{
+    unsigned long sum = 0;
+    for (size_t i = 0; i < count; i++)
+        sum += hot[i];
+    return sum;
+}
+
+// Moves a large block with mem_resize (a blocker behind it forbids growing in
+// place) and then rescans a hot buffer, with and without non-temporal copies
+void bench_resize_copy(size_t size, int rounds)
+{
+    printf_yellow("  Benchmarking mem_resize moves of %zu MiB (rounds: %d) ---> ", size >> 20, rounds);
+    size_t hot_count = (256 * 1024) / sizeof(unsigned long);
+    unsigned long *hot = malloc(hot_count * sizeof(unsigned long));
+    for (size_t i = 0; i < hot_count; i++)
+        hot[i] = i;
+    double move_ms[2] = {0, 0}, rescan_us[2] = {0, 0};
+    size_t threshold = mm_set_nt_threshold(SIZE_MAX);
+
+    mem_init(4 * size + 4096);
+    for (int variant = 0; variant < 2; variant++)
+    {
+        mm_set_nt_threshold(variant == 0 ? SIZE_MAX : 0);
+        for (int r = 0; r < rounds; r++)
+        {
+            char *block = mem_alloc(size);
+            memset(block, r, size);
+            void *blocker = mem_alloc(8);
+            scan_hot(hot, hot_count);
+
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            char *moved = mem_resize(block, size + size / 2);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            move_ms[variant] += elapsed_ms(&start, &end);
+            my_assert(moved != block && moved[size - 1] == (char)r);
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            scan_hot(hot, hot_count);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            rescan_us[variant] += elapsed_ms(&start, &end) * 1e3;
+
+            mem_free(moved);
+            mem_free(blocker);
+        }
+    }
+    mem_deinit();
+    mm_set_nt_threshold(threshold);
+    free(hot);
+
+    printf_green("[DONE].\n");
+    printf("\tmemcpy: %.3f ms move, %.1f us hot rescan; non-temporal: %.3f ms move, %.1f us hot rescan\n",
+           move_ms[0] / rounds, rescan_us[0] / rounds, move_ms[1] / rounds, rescan_us[1] / rounds);
+}
+
+void test_init_prefault()
+{
+    printf_yellow("  Testing mem_init_opts with prefault and mem_stats ---> ");
+    size_t size = 8 * 1024 * 1024;
+    struct mm_stats st;
+
+    mem_init(size);
+    mem_stats(&st);
+    my_assert(st.pool_size == size && st.free_blocks == 1 && st.warmup_ns == 0);
+    my_assert(st.free_bytes == st.largest_free && st.free_bytes < size);
+    mem_deinit();
+
+    struct mm_init_opts opts = {.prefault = 1, .threads = 2};
+    mem_init_opts(size, &opts);
+    mem_stats(&st);
+    my_assert(st.warmup_ns > 0 && st.warmup_threads == 2);
+
+    // Touching the pages must not disturb the block list or the zero flag
+    unsigned char *block = mem_calloc(1, size / 2);
+    my_assert(block != NULL && all_zero(block, size / 2));
+    void *small = mem_alloc(100);
+    mem_stats(&st);
+    my_assert(st.free_blocks == 1 && st.free_bytes < size / 2);
+    mem_free(block);
+    mem_free(small);
+
+    // Regions added later are warmed as well
+    uint64_t before = st.warmup_ns;
+    my_assert(mem_grow(size) == 0);
+    mem_stats(&st);
+    my_assert(st.pool_size == 2 * size && st.warmup_ns > before);
+    mem_deinit();
+
+    printf_green("[PASS].\n");
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Allocates the whole pool in 1 MiB blocks and writes each one, with and
+// without prefault at init; reports the total and the median block
+void bench_first_touch(size_t size)
+{
+    printf_yellow("  Benchmarking first touch of a %zu MiB pool ---> ", size >> 20);
+    size_t chunk = 1024 * 1024;
+    size_t count = size / (chunk + 64) - 1;
+    void **blocks = malloc(count * sizeof(void *));
+    double *block_us = malloc(count * sizeof(double));
+    double total_ms[2], median_us[2];
+    struct mm_stats st;
+
+    for (int variant = 0; variant < 2; variant++)
+    {
+        struct mm_init_opts opts = {.prefault = variant, .threads = 0};
+        mem_init_opts(size, &opts);
+        mem_stats(&st);
+        total_ms[variant] = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            blocks[i] = mem_alloc(chunk);
+            memset(blocks[i], (int)i, chunk);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            block_us[i] = elapsed_ms(&start, &end) * 1e3;
+            total_ms[variant] += block_us[i] / 1e3;
+        }
+        qsort(block_us, count, sizeof(double), cmp_double);
+        median_us[variant] = block_us[count / 2];
+        for (size_t i = 0; i < count; i++)
+            mem_free(blocks[i]);
+        mem_deinit();
+    }
+    free(blocks);
+    free(block_us);
+
+    printf_green("[DONE].\n");
+    printf("\tcold: %.2f ms, median block %.1f us; prefaulted: %.2f ms, median block %.1f us (warm-up %.2f ms, %u threads)\n",
+           total_ms[0], median_us[0], total_ms[1], median_us[1], st.warmup_ns / 1e6, st.warmup_threads);
+}
+
+void test_profile_carving()
+{
+    printf_yellow("  Testing size histogram, profiles and pre-carved classes ---> ");
+    size_t size = 1024 * 1024;
+    void *small[100], *medium[50];
+    struct mm_size_hist *hist = malloc(sizeof(*hist));
+    struct mm_stats st;
+
+    // A first run to collect the size mix
+    mem_init(size);
+    for (int i = 0; i < 100; i++)
+        small[i] = mem_alloc(20 + i % 5);
+    for (int i = 0; i < 50; i++)
+        medium[i] = mem_alloc(100);
+    for (int i = 0; i < 100; i++)
+        mem_free(small[i]);
+    for (int i = 0; i < 50; i++)
+        mem_free(medium[i]);
+    mem_deinit();
+
+    mem_size_histogram(hist);
+    my_assert(hist->allocs[20] == 20 && hist->peak_live[100] == 50 && hist->live[100] == 0);
+
+    struct mm_profile_entry profile[MM_PROFILE_MAX];
+    size_t len = mem_profile_from_histogram(hist, profile, MM_PROFILE_MAX);
+    my_assert(len == 2);
+    my_assert(profile[0].size == 24 && profile[0].count == 100);
+    my_assert(profile[1].size == 104 && profile[1].count == 50);
+
+    const char *path = "/tmp/test_memory_manager.profile";
+    struct mm_profile_entry loaded[MM_PROFILE_MAX];
+    my_assert(mem_profile_save(path, profile, len) == 0);
+    my_assert(mem_profile_load(path, loaded, MM_PROFILE_MAX) == (int)len);
+    my_assert(loaded[1].size == 104 && loaded[1].count == 50);
+    remove(path);
+
+    // The second run gets the blocks cut out in advance
+    struct mm_init_opts opts = {.profile = loaded, .profile_len = len};
+    mem_init_opts(size, &opts);
+    mem_stats(&st);
+    my_assert(st.carved_blocks == 150 && st.carved_bytes == 100 * 24 + 50 * 104);
+
+    unsigned char *first = mem_calloc(1, 17);
+    my_assert(first != NULL && all_zero(first, 24) && mem_usable_size(first) == 24);
+    for (int i = 0; i < 99; i++)
+        small[i] = mem_alloc(24);
+    for (int i = 0; i < 50; i++)
+        medium[i] = mem_alloc(97);
+    my_assert(medium[0] > small[98] && medium[49] > medium[0]);
+    mem_stats(&st);
+    my_assert(st.carved_blocks == 0);
+
+    // An empty class gets a new slab from the pool, a freed block goes back to its class
+    void *extra = mem_alloc(24);
+    my_assert(extra != NULL && (char *)extra > (char *)medium[49]);
+    my_assert(mem_usable_size(extra) == 24);
+    mem_free(small[10]);
+    my_assert(mem_alloc(18) == small[10]);
+
+    // Growing past the class moves the block and returns it to the list
+    mem_stats(&st);
+    size_t carved = st.carved_blocks;
+    char *grown = mem_resize(medium[3], 500);
+    my_assert(grown != medium[3]);
+    mem_stats(&st);
+    my_assert(st.carved_blocks == carved + 1);
+    my_assert(mem_alloc(104) == medium[3]);
+
+    // A double free must not put the block on its class list twice
+    mem_free(small[20]);
+    mem_free(small[20]);
+    mem_stats(&st);
+    my_assert(st.carved_blocks == carved + 1);
+    void *once = mem_alloc(24);
+    void *twice = mem_alloc(24);
+    my_assert(once == small[20] && twice != once);
+    mem_deinit();
+
+    free(hist);
+    printf_green("[PASS].\n");
+}
+
+// A burst of mixed small allocations straight after init, without and with
+// a profile made from the first run's histogram
+void bench_carved_burst(int count)
+{
+    printf_yellow("  Benchmarking an allocation burst of %d blocks ---> ", count);
+    static const size_t sizes[] = {24, 40, 40, 72, 136, 24, 264, 40};
+    size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    size_t pool = (size_t)count * 256;
+    void **blocks = malloc(count * sizeof(void *));
+    struct mm_size_hist *hist = malloc(sizeof(*hist));
+    struct mm_profile_entry profile[MM_PROFILE_MAX];
+    size_t len = 0;
+    double ms[2];
+
+    for (int variant = 0; variant < 2; variant++)
+    {
+        struct mm_init_opts opts = {.profile = variant ? profile : NULL, .profile_len = len};
+        mem_init_opts(pool, &opts);
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < count; i++)
+            blocks[i] = mem_alloc(sizes[i % nsizes]);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ms[variant] = elapsed_ms(&start, &end);
+        my_assert(blocks[count - 1] != NULL);
+
+        for (int i = 0; i < count; i++)
+            mem_free(blocks[i]);
+        mem_deinit();
+
+        mem_size_histogram(hist);
+        len = mem_profile_from_histogram(hist, profile, MM_PROFILE_MAX);
+    }
+    free(hist);
+    free(blocks);
+
+    printf_green("[DONE].\n");
+    printf("\tfirst-fit: %.2f ms (%.0f ns/alloc), pre-carved: %.2f ms (%.0f ns/alloc), %zu classes\n",
+           ms[0], ms[0] * 1e6 / count, ms[1], ms[1] * 1e6 / count, len);
+}
+
+// Internal waste of the classes for the histogram, as the allocator counts it
+static uint64_t hist_waste(const struct mm_size_hist *hist, const size_t *classes, size_t n)
+{
+    uint64_t waste = 0;
+    for (size_t s = 1; s <= MM_HIST_MAX; s++)
+    {
+        size_t c = 0;
+        while (c < n && classes[c] < s)
+            c++;
+        waste += hist->peak_live[s] * ((c < n ? classes[c] : (s + 7) / 8 * 8) - s);
+    }
+    return waste;
+}
+
+void test_class_tuning()
+{
+    printf_yellow("  Testing size-class tuning from the histogram ---> ");
+    struct mm_size_hist *hist = malloc(sizeof(*hist));
+    struct mm_stats st;
+    void *blocks[60];
+
+    // Coarse classes to start with, as a fixed geometric set would give
+    struct mm_profile_entry coarse[] = {{64, 10}, {256, 10}};
+    struct mm_init_opts opts = {.profile = coarse, .profile_len = 2};
+    mem_init_opts(1024 * 1024, &opts);
+
+    void *old = mem_alloc(20);
+    my_assert(mem_usable_size(old) == 64);
+    for (int i = 0; i < 60; i++)
+        blocks[i] = mem_alloc(i < 30 ? 20 : i < 45 ? 40 : i < 50 ? 100 : 200);
+
+    my_assert(mem_tune_classes(3) == 3);
+    mem_stats(&st);
+    my_assert(st.tunings == 1 && st.num_classes == 3);
+    my_assert(st.waste_after < st.waste_before);
+
+    // The choice must match an exhaustive search over the candidate sizes
+    mem_size_histogram(hist);
+    size_t cand[] = {24, 40, 104, 200};
+    uint64_t best = UINT64_MAX;
+    for (int a = 0; a < 3; a++)
+        for (int b = a + 1; b < 3; b++)
+        {
+            size_t classes[3] = {cand[a], cand[b], 200};
+            uint64_t waste = hist_waste(hist, classes, 3);
+            if (waste < best)
+                best = waste;
+        }
+    my_assert(st.waste_after == best && hist_waste(hist, st.classes, 3) == best);
+    my_assert(st.classes[0] == 24 && st.classes[1] == 40 && st.classes[2] == 200);
+
+    // A block from a class that went away is an ordinary block again
+    size_t carved = st.carved_blocks;
+    mem_free(old);
+    mem_stats(&st);
+    my_assert(st.carved_blocks == carved);
+    void *fresh = mem_alloc(20);
+    my_assert(mem_usable_size(fresh) == 24);
+    mem_free(fresh);
+    for (int i = 0; i < 60; i++)
+        mem_free(blocks[i]);
+    mem_deinit();
+
+    // Automatic tuning after every 100 allocations
+    struct mm_init_opts autotune = {.tune_interval = 100, .tune_classes = 4};
+    mem_init_opts(1024 * 1024, &autotune);
+    for (int i = 0; i < 60; i++)
+        blocks[i] = mem_alloc(20);
+    for (int i = 0; i < 60; i++)
+        mem_free(blocks[i]);
+    mem_stats(&st);
+    my_assert(st.tunings == 0 && st.num_classes == 0);
+    for (int i = 0; i < 60; i++)
+        blocks[i] = mem_alloc(20);
+    mem_stats(&st);
+    my_assert(st.tunings == 1 && st.num_classes == 1 && st.classes[0] == 24);
+    my_assert(mem_usable_size(blocks[59]) == 24);
+    for (int i = 0; i < 60; i++)
+        mem_free(blocks[i]);
+    mem_deinit();
+
+    free(hist);
+    printf_green("[PASS].\n");
+}
+
+// Odd-sized objects under power-of-two classes, then under classes tuned
+// from the same workload; reports the measured waste of the live blocks
+void bench_class_waste(int count)
+{
+    printf_yellow("  Measuring internal waste of %d odd-sized blocks ---> ", count);
+    static const size_t sizes[] = {13, 27, 44, 71, 90, 150, 200, 333};
+    size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    struct mm_profile_entry pow2[] = {{16, 0}, {32, 0}, {64, 0}, {128, 0}, {256, 0}, {512, 0}};
+    struct mm_init_opts opts = {.profile = pow2, .profile_len = 6};
+    void **blocks = malloc(count * sizeof(void *));
+    size_t waste[2], classes = 0;
+    struct mm_stats st;
+
+    mem_init_opts((size_t)count * 512, &opts);
+    for (int round = 0; round < 2; round++)
+    {
+        for (int i = 0; i < count; i++)
+            blocks[i] = mem_alloc(sizes[i % nsizes]);
+        mem_stats(&st);
+        waste[round] = st.live_waste;
+        for (int i = 0; i < count; i++)
+            mem_free(blocks[i]);
+        if (round == 0)
+            classes = (size_t)mem_tune_classes(nsizes);
+    }
+    mem_stats(&st);
+    mem_deinit();
+    free(blocks);
+
+    printf_green("[DONE].\n");
+    printf("\tpower-of-two classes: %zu bytes wasted, %zu tuned classes: %zu bytes (estimate %llu -> %llu)\n",
+           waste[0], classes, waste[1], (unsigned long long)st.waste_before, (unsigned long long)st.waste_after);
+}
+
+void test_alloc_hints()
+{
+    printf_yellow("  Testing lifetime and hot/cold hints in mem_alloc_hint ---> ");
+    size_t header = sizeof(struct mm_block_header);
+    struct mm_stats st;
+    mem_init(1024 * 1024);
+
+    // Long-lived at the bottom, short-lived from the top down
+    char *long1 = mem_alloc_hint(100, MM_HINT_LONG_LIVED);
+    my_assert((uintptr_t)long1 == mm_pool_info.start + header);
+    char *short1 = mem_alloc_hint(100, MM_HINT_SHORT_LIVED);
+    my_assert((uintptr_t)short1 + 104 == mm_pool_info.end);
+    char *short2 = mem_alloc_hint(40, MM_HINT_SHORT_LIVED);
+    my_assert(short2 + 40 + header == short1 && mem_usable_size(short2) == 40);
+
+    // Hot blocks follow each other even with other allocations in between
+    char *hot1 = mem_alloc_hint(32, MM_HINT_HOT);
+    char *long2 = mem_alloc(64);
+    char *hot2 = mem_alloc_hint(32, MM_HINT_HOT);
+    my_assert(hot1 == long1 + 104 + header);
+    my_assert(hot2 == hot1 + 32 + header && long2 > hot2);
+    mem_stats(&st);
+    my_assert(st.hot_reserve > 0 && st.hot_reserve < 64 * 1024);
+
+    // Freed short-lived blocks leave no holes behind
+    mem_free(short1);
+    mem_free(short2);
+    mem_stats(&st);
+    my_assert(st.free_blocks == 1 && st.largest_free == st.free_bytes);
+
+    // An exhausted reserve is given back and a new one taken
+    char *prev_end = hot2 + 32;
+    int jumps = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        char *hot = mem_alloc_hint(1000, MM_HINT_HOT);
+        my_assert(hot != NULL);
+        jumps += hot != prev_end + header;
+        prev_end = hot + 1000;
+    }
+    my_assert(jumps == 1);
+
+    struct mm_size_hist *hist = malloc(sizeof(*hist));
+    mem_size_histogram(hist);
+    my_assert(hist->allocs[100] == 2 && hist->allocs[1000] == 100);
+    free(hist);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Long-lived nodes interleaved with transient buffers, with and without
+// hints. Reports how scattered the nodes are and how fragmented the free
+// space is once the buffers are gone
+void bench_lifetime_hints(int count)
+{
+    printf_yellow("  Benchmarking %d long-lived nodes among transient buffers ---> ", count);
+    enum { WINDOW = 16 };
+    void **nodes = malloc(count * sizeof(void *));
+    struct mm_stats st[2];
+    size_t span[2];
+    double ms[2];
+
+    for (int hinted = 0; hinted < 2; hinted++)
+    {
+        void *buffers[WINDOW] = {0};
+        mem_init((size_t)count * 64 + 16 * 1024 * 1024);
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < count; i++)
+        {
+            nodes[i] = mem_alloc_hint(48, hinted ? MM_HINT_LONG_LIVED : MM_HINT_NONE);
+            mem_free(buffers[i % WINDOW]);
+            buffers[i % WINDOW] = mem_alloc_hint(256 + (i * 37) % 1792, hinted ? MM_HINT_SHORT_LIVED : MM_HINT_NONE);
+            my_assert(nodes[i] != NULL && buffers[i % WINDOW] != NULL);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ms[hinted] = elapsed_ms(&start, &end);
+
+        for (int i = 0; i < WINDOW; i++)
+            mem_free(buffers[i]);
+        mem_stats(&st[hinted]);
+
+        uintptr_t lo = UINTPTR_MAX, hi = 0;
+        for (int i = 0; i < count; i++)
+        {
+            lo = (uintptr_t)nodes[i] < lo ? (uintptr_t)nodes[i] : lo;
+            hi = (uintptr_t)nodes[i] > hi ? (uintptr_t)nodes[i] : hi;
+            mem_free(nodes[i]);
+        }
+        span[hinted] = hi - lo;
+        mem_deinit();
+    }
+    free(nodes);
+
+    printf_green("[DONE].\n");
+    for (int hinted = 0; hinted < 2; hinted++)
+        printf("\t%s: %.1f ms, nodes span %zu KiB, %zu free blocks, %zu KiB in holes outside the largest\n",
+               hinted ? "hinted  " : "no hints", ms[hinted], span[hinted] >> 10, st[hinted].free_blocks,
+               (st[hinted].free_bytes - st[hinted].largest_free) >> 10);
+}
+
 int main(int argc, char *argv[])
 {
 #ifdef VERSION
@@ -902,7 +1481,13 @@ int main(int argc, char *argv[])
         printf("  0. tests various functions with a base number of threads\n");
         printf("  1. tests various functions across variious configurations (number of threads, memory sizes,  iterations)\n");
         printf("  2. stress tests various functions with various configurations. This may take some time (especially if simulate_work flag is set to true.\n");
-        printf("  3. test_looking_for_out_of_bounds, needs LD_PRELOAD=./libmymalloc.so .\n\n");
+        printf("  3. test_looking_for_out_of_bounds, needs LD_PRELOAD=./libmymalloc.so .\n");
+        printf("  4. test_calloc_zeroed and bench_calloc_fresh - mem_calloc skips memset on known-zero memory\n");
+        printf("  5. bench_resize_copy [MiB] - mem_resize moves with memcpy and with non-temporal copies\n");
+        printf("  6. test_init_prefault and bench_first_touch [MiB] - prefaulting the pool at init\n");
+        printf("  7. test_profile_carving and bench_carved_burst - size classes cut out at init from a profile\n");
+        printf("  8. test_class_tuning and bench_class_waste - size classes tuned from observed sizes\n");
+        printf("  9. test_alloc_hints and bench_lifetime_hints - lifetime and hot/cold placement hints\n\n");
         return 1;
     }
 
@@ -985,6 +1570,35 @@ int main(int argc, char *argv[])
         test_looking_for_out_of_bounds();
         break;
 
+    case 4:
+        test_calloc_zeroed();
+        bench_calloc_fresh((size_t)64 << 20);
+        break;
+
+    case 5:
+        bench_resize_copy((size_t)(argc > 2 ? atoi(argv[2]) : 16) << 20, 10);
+        break;
+
+    case 6:
+        test_init_prefault();
+        bench_first_touch((size_t)(argc > 2 ? atoi(argv[2]) : 256) << 20);
+        break;
+
+    case 7:
+        test_profile_carving();
+        bench_carved_burst(5000);
+        break;
+
+    case 8:
+        test_class_tuning();
+        bench_class_waste(20000);
+        break;
+
+    case 9:
+        test_alloc_hints();
+        bench_lifetime_hints(5000);
+        break;
+
     default:
         printf("Invalid test function\n");
         break;
@@ -0,0 +1,134 @@
+#include "mm_memory_resource.hpp"
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common_defs.h"
+#include "gitdata.h"
+
+#define POOL_SIZE (4 * 1024 * 1024)
+
+// ********* Aligned C API *********
+
+void test_mem_alloc_aligned()
+{
+    printf_yellow("  Testing mem_alloc_aligned and mem_free_sized ---> ");
+    mem_init(POOL_SIZE);
+
+    my_assert(mem_alloc_aligned(16, 24) == nullptr); // not a power of two
+
+    void *blocks[64];
+    for (int i = 0; i < 64; i++)
+    {
+        size_t align = (size_t)8 << (i % 10); // 8 .. 4096
+        blocks[i] = mem_alloc_aligned(40 + i, align);
+        my_assert(blocks[i] != nullptr);
+        my_assert((uintptr_t)blocks[i] % align == 0);
+        memset(blocks[i], i, 40 + i);
+    }
+    for (int i = 0; i < 64; i++)
+    {
+        my_assert(((unsigned char *)blocks[i])[39 + i] == i);
+        mem_free_sized(blocks[i], 40 + i);
+    }
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* pmr containers *********
+
+struct alignas(64) CacheLine
+{
+    char bytes[64];
+};
+
+void test_pool_resource()
+{
+    printf_yellow("  Testing std::pmr containers on mm::pool_resource ---> ");
+    mem_init(POOL_SIZE);
+    std::pmr::memory_resource *resource = mm::pool_resource::instance();
+    my_assert(resource->is_equal(*mm::pool_resource::instance()));
+    my_assert(!resource->is_equal(*std::pmr::new_delete_resource()));
+
+    {
+        std::pmr::vector<int> values(resource);
+        for (int i = 0; i < 10000; i++)
+            values.push_back(i);
+        my_assert(values.size() == 10000 && values[9999] == 9999);
+
+        // The whole graph, keys and nested strings included, comes from the pool
+        std::pmr::unordered_map<int, std::pmr::string> names(resource);
+        for (int i = 0; i < 1000; i++)
+            names.emplace(i, std::pmr::string(64, 'a' + i % 26));
+        my_assert(names.size() == 1000 && names.at(27)[0] == 'b');
+        my_assert(names.at(27).get_allocator().resource()->is_equal(*resource));
+
+        std::pmr::map<int, CacheLine> lines(resource);
+        for (int i = 0; i < 100; i++)
+            lines[i].bytes[0] = i;
+        my_assert(lines[42].bytes[0] == 42);
+        my_assert((uintptr_t)&lines[42] % alignof(CacheLine) == 0);
+
+        // Over-aligned requests straight through the resource
+        void *page = resource->allocate(100, 4096);
+        my_assert((uintptr_t)page % 4096 == 0);
+        resource->deallocate(page, 100, 4096);
+
+        // Exhausting the pool surfaces as std::bad_alloc
+        bool thrown = false;
+        try
+        {
+            (void)resource->allocate(POOL_SIZE * 2);
+        }
+        catch (const std::bad_alloc &)
+        {
+            thrown = true;
+        }
+        my_assert(thrown);
+    }
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_mem_alloc_aligned - Aligned allocation and sized free\n");
+        printf(" 2. test_pool_resource - std::pmr containers on the pool\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+        test_mem_alloc_aligned();
+        test_pool_resource();
+        break;
+    case 1:
+        test_mem_alloc_aligned();
+        break;
+    case 2:
+        test_pool_resource();
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Uses only the standard allocation functions; run it with
+// LD_PRELOAD=./libmymalloc.so (make run_test_mymalloc) to test the interposer
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "common_defs.h"
+#include "gitdata.h"
+
+// ********* Single thread *********
+
+void test_mymalloc_basic(void)
+{
+    printf_yellow("  Testing malloc/calloc/realloc/posix_memalign/aligned_alloc ---> ");
+
+    // malloc alignment for every size
+    void *blocks[512];
+    for (int i = 0; i < 512; i++)
+    {
+        blocks[i] = malloc(i);
+        my_assert(blocks[i] != NULL);
+        my_assert((uintptr_t)blocks[i] % 16 == 0);
+        my_assert(malloc_usable_size(blocks[i]) >= (size_t)i);
+        memset(blocks[i], i, i);
+    }
+    for (int i = 0; i < 512; i += 2)
+        free(blocks[i]);
+
+    // calloc is zeroed even on reused memory
+    for (int i = 1; i < 512; i += 2)
+    {
+        unsigned char *p = calloc(i, 1);
+        for (int k = 0; k < i; k++)
+            my_assert(p[k] == 0);
+        free(p);
+    }
+    volatile size_t too_many = SIZE_MAX / 2;
+    my_assert(calloc(too_many, 4) == NULL);
+
+    // realloc keeps the contents while growing and shrinking
+    char *text = malloc(8);
+    strcpy(text, "abcdefg");
+    for (size_t size = 16; size <= 1 << 20; size *= 2)
+    {
+        text = realloc(text, size);
+        my_assert(text != NULL && (uintptr_t)text % 16 == 0);
+        my_assert(strcmp(text, "abcdefg") == 0);
+    }
+    text = realloc(text, 4);
+    my_assert(memcmp(text, "abcd", 4) == 0);
+    free(text);
+
+    void *aligned = NULL;
+    my_assert(posix_memalign(&aligned, 4096, 100) == 0);
+    my_assert((uintptr_t)aligned % 4096 == 0);
+    free(aligned);
+    my_assert(posix_memalign(&aligned, 24, 100) != 0);
+    aligned = aligned_alloc(64, 256);
+    my_assert(aligned != NULL && (uintptr_t)aligned % 64 == 0);
+    free(aligned);
+
+    // Larger than the initial pool: the interposer grows it
+    char *huge = malloc(96 << 20);
+    my_assert(huge != NULL);
+    huge[0] = huge[(96 << 20) - 1] = 1;
+    free(huge);
+
+    for (int i = 1; i < 512; i += 2)
+    {
+        my_assert(((unsigned char *)blocks[i])[i - 1] == (unsigned char)i);
+        free(blocks[i]);
+    }
+    printf_green("[PASS].\n");
+}
+
+// ********* Threads *********
+
+void *thread_mymalloc_function(void *arg)
+{
+    unsigned int seed = (uintptr_t)arg;
+    void *live[64] = {0};
+    for (int i = 0; i < 20000; i++)
+    {
+        int k = rand_r(&seed) % 64;
+        if (live[k])
+        {
+            my_assert(*(unsigned char *)live[k] == k);
+            free(live[k]);
+            live[k] = NULL;
+        }
+        else
+        {
+            live[k] = malloc(1 + rand_r(&seed) % 1024);
+            *(unsigned char *)live[k] = k;
+        }
+    }
+    for (int k = 0; k < 64; k++)
+        free(live[k]);
+    return NULL;
+}
+
+void test_mymalloc_multithread(int num_threads)
+{
+    printf_yellow("  Testing malloc/free with %d threads ---> ", num_threads);
+    pthread_t threads[num_threads];
+    for (int i = 0; i < num_threads; i++)
+        pthread_create(&threads[i], NULL, thread_mymalloc_function, (void *)(uintptr_t)(i + 1));
+    for (int i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+    printf_green("[PASS].\n");
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    // The interposer rounds a 1-byte request to 8 usable bytes, glibc to 24
+    void *probe = malloc(1);
+    printf("Allocator; %s\n", malloc_usable_size(probe) == 8 ? "libmymalloc.so" : "libc (LD_PRELOAD not set?)");
+    free(probe);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_mymalloc_basic - The allocation functions, alignment and pool growth\n");
+        printf(" 2. test_mymalloc_multithread - Random malloc/free with various numbers of threads\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+    case 1:
+        test_mymalloc_basic();
+        if (atoi(argv[1]) == 1)
+            break;
+        // fall through
+    case 2:
+        for (int i = 0; i < 5; i++) // 1 to 16 threads
+            test_mymalloc_multithread(pow(2, i));
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "mm_object_pool.hpp"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "common_defs.h"
+#include "gitdata.h"
+
+#define POOL_SIZE (4 * 1024 * 1024)
+
+static int alive = 0; // Counter objects currently constructed
+
+struct Counter
+{
+    std::string name;
+    std::unique_ptr<int> payload;
+    int copies = 0;
+
+    Counter(const std::string &n, std::unique_ptr<int> p) : name(n), payload(std::move(p)) { alive++; }
+    Counter(const Counter &other) : name(other.name), copies(other.copies + 1) { alive++; }
+    ~Counter() { alive--; }
+};
+
+struct alignas(32) Wide
+{
+    double lanes[4];
+};
+
+struct Throwing
+{
+    explicit Throwing(bool fail)
+    {
+        if (fail)
+            throw std::runtime_error("constructor failed");
+    }
+};
+
+// ********* Construction and reuse *********
+
+void test_object_pool_basic(int count)
+{
+    printf_yellow("  Testing mm::object_pool make/reuse (objects: %d) ---> ", count);
+    mem_init(POOL_SIZE);
+    {
+        static_assert(mm::object_pool<char>::slot_size == sizeof(void *), "slot holds the freelist link");
+        static_assert(mm::object_pool<Wide>::slot_size == 32 && mm::object_pool<Wide>::slot_align == 32, "slot follows alignof(T)");
+
+        mm::object_pool<Counter, 16> pool;
+        std::vector<mm::object_pool<Counter, 16>::pointer> objects;
+
+        // Arguments are forwarded: the unique_ptr is moved, the string copied
+        std::string name = "counter";
+        for (int i = 0; i < count; i++)
+            objects.push_back(pool.make(name, std::make_unique<int>(i)));
+        my_assert(alive == count);
+        my_assert(pool.in_use() == (size_t)count);
+        my_assert(pool.capacity() >= (size_t)count && pool.capacity() % 16 == 0);
+        my_assert(*objects[count - 1]->payload == count - 1 && name == "counter");
+
+        Counter original("original", nullptr);
+        auto copy = pool.make(original);
+        my_assert(copy->copies == 1);
+        copy.reset();
+
+        // A freed slot is the next one handed out
+        Counter *released = objects.back().get();
+        objects.pop_back();
+        my_assert(alive == count); // count - 1 in the pool plus original
+        auto again = pool.make("again", nullptr);
+        my_assert(again.get() == released);
+
+        size_t capacity = pool.capacity();
+        objects.clear();
+        again.reset();
+        my_assert(pool.in_use() == 0 && pool.capacity() == capacity);
+
+        mm::object_pool<Wide> wide;
+        for (int i = 0; i < 100; i++)
+        {
+            auto w = wide.make();
+            my_assert((uintptr_t)w.get() % 32 == 0);
+        }
+
+        // A throwing constructor gives its slot back
+        mm::object_pool<Throwing> throwing;
+        bool thrown = false;
+        try
+        {
+            auto t = throwing.make(true);
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        my_assert(thrown && throwing.in_use() == 0);
+    }
+    my_assert(alive == 0);
+    my_assert(pool_is_empty(POOL_SIZE));
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_object_pool_basic - Construction, slot reuse and alignment\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+    case 1:
+        test_object_pool_basic(1000);
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include "ring_buffer.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sched.h>
+#include <math.h>
+#include "common_defs.h"
+#include "gitdata.h"
+
+typedef struct
+{
+    RingBuffer *ring;
+    int thread_id;
+    int num_items;        // items produced by each producer
+    atomic_int *consumed; // total number of items popped
+    atomic_long *sum;     // sum of all popped items
+    int total;            // items the consumers should take in total
+    bool zero_copy;       // use reserve/commit and peek/release
+} thread_data_t;
+
+typedef struct
+{
+    RingMode mode;
+    int num_producers;
+    int num_consumers;
+    int num_items;
+    int capacity;
+    bool zero_copy;
+} TestParams;
+
+// ********* Single-threaded behaviour *********
+
+void test_ring_basic(RingMode mode)
+{
+    printf_yellow("  Testing ring buffer basics (%s) ---> ", mode == RING_MPMC ? "MPMC" : "SPSC");
+    mem_init(64 * 1024);
+
+    RingBuffer *ring = ring_create(mode, 6, sizeof(uint32_t));
+    my_assert(ring != NULL);
+    my_assert(ring_capacity(ring) == 8); // rounded up to a power of two
+
+    uint32_t value = 0;
+    my_assert(ring_pop(ring, &value) == 0);
+
+    // Fill, overflow and drain several times to exercise the wrap-around
+    for (int round = 0; round < 3; round++)
+    {
+        for (uint32_t i = 0; i < 8; i++)
+            my_assert(ring_push(ring, &i) == 1);
+        my_assert(ring_push(ring, &value) == 0);
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            my_assert(ring_pop(ring, &value) == 1);
+            my_assert(value == i);
+        }
+        my_assert(ring_pop(ring, &value) == 0);
+        ring_push(ring, &value); // shift the start position for the next round
+        ring_pop(ring, &value);
+    }
+
+    // Batches are cut at the free space / available items
+    uint32_t in[12], out[12];
+    for (int i = 0; i < 12; i++)
+        in[i] = 100 + i;
+    my_assert(ring_push_batch(ring, in, 5) == 5);
+    my_assert(ring_push_batch(ring, in + 5, 7) == 3);
+    my_assert(ring_pop_batch(ring, out, 12) == 8);
+    for (int i = 0; i < 8; i++)
+        my_assert(out[i] == in[i]);
+
+    // Zero-copy slots
+    size_t ticket;
+    uint32_t *slot = ring_reserve(ring, &ticket);
+    my_assert(slot != NULL);
+    *slot = 4711;
+    ring_commit(ring, ticket);
+    const uint32_t *read = ring_peek(ring, &ticket);
+    my_assert(read != NULL && *read == 4711);
+    ring_release(ring, ticket);
+    my_assert(ring_peek(ring, &ticket) == NULL);
+
+    ring_destroy(ring);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Concurrency *********
+
+void *thread_ring_producer(void *arg)
+{
+    thread_data_t *data = (thread_data_t *)arg;
+    int i = 0;
+    uint32_t batch[8];
+
+    while (i < data->num_items)
+    {
+        if (data->zero_copy)
+        {
+            size_t ticket;
+            uint32_t *slot = ring_reserve(data->ring, &ticket);
+            if (slot)
+            {
+                *slot = i++;
+                ring_commit(data->ring, ticket);
+            }
+            else
+                sched_yield(); // full, let a consumer run
+            continue;
+        }
+        int n = data->num_items - i < 8 ? data->num_items - i : 8;
+        for (int k = 0; k < n; k++)
+            batch[k] = i + k;
+        size_t pushed = ring_push_batch(data->ring, batch, n);
+        if (pushed == 0)
+            sched_yield();
+        i += pushed;
+    }
+    return NULL;
+}
+
+void *thread_ring_consumer(void *arg)
+{
+    thread_data_t *data = (thread_data_t *)arg;
+    uint32_t batch[8];
+
+    while (atomic_load(data->consumed) < data->total)
+    {
+        if (data->zero_copy)
+        {
+            size_t ticket;
+            const uint32_t *slot = ring_peek(data->ring, &ticket);
+            if (slot)
+            {
+                atomic_fetch_add(data->sum, *slot);
+                ring_release(data->ring, ticket);
+                atomic_fetch_add(data->consumed, 1);
+            }
+            else
+                sched_yield(); // empty, let a producer run
+            continue;
+        }
+        size_t n = ring_pop_batch(data->ring, batch, 8);
+        if (n == 0)
+            sched_yield();
+        for (size_t k = 0; k < n; k++)
+            atomic_fetch_add(data->sum, batch[k]);
+        atomic_fetch_add(data->consumed, n);
+    }
+    return NULL;
+}
+
+void test_ring_multithread(TestParams *params)
+{
+    printf_yellow("  Testing %s ring (producers: %d, consumers: %d, capacity: %d%s) ---> ", params->mode == RING_MPMC ? "MPMC" : "SPSC",
+                  params->num_producers, params->num_consumers, params->capacity, params->zero_copy ? ", zero-copy" : "");
+    mem_init(params->capacity * 32 + 64 * 1024);
+
+    RingBuffer *ring = ring_create(params->mode, params->capacity, sizeof(uint32_t));
+    atomic_int consumed = 0;
+    atomic_long sum = 0;
+    int threads_total = params->num_producers + params->num_consumers;
+    pthread_t threads[threads_total];
+    thread_data_t thread_data[threads_total];
+
+    for (int i = 0; i < threads_total; i++)
+    {
+        thread_data[i].ring = ring;
+        thread_data[i].thread_id = i;
+        thread_data[i].num_items = params->num_items;
+        thread_data[i].consumed = &consumed;
+        thread_data[i].sum = &sum;
+        thread_data[i].total = params->num_items * params->num_producers;
+        thread_data[i].zero_copy = params->zero_copy;
+        pthread_create(&threads[i], NULL, i < params->num_producers ? thread_ring_producer : thread_ring_consumer, &thread_data[i]);
+    }
+    for (int i = 0; i < threads_total; i++)
+        pthread_join(threads[i], NULL);
+
+    long expected = (long)params->num_producers * params->num_items * (params->num_items - 1) / 2;
+    my_assert(atomic_load(&consumed) == params->num_items * params->num_producers);
+    my_assert(atomic_load(&sum) == expected);
+
+    ring_destroy(ring);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_ring_basic - Wrap-around, batches and zero-copy slots in both modes\n");
+        printf(" 2. test_ring_multithread - SPSC pair and MPMC with various numbers of threads\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+    case 1:
+        test_ring_basic(RING_SPSC);
+        test_ring_basic(RING_MPMC);
+        if (atoi(argv[1]) == 1)
+            break;
+        // fall through
+    case 2:
+        for (int zero_copy = 0; zero_copy <= 1; zero_copy++)
+        {
+            test_ring_multithread(&(TestParams){.mode = RING_SPSC, .num_producers = 1, .num_consumers = 1, .num_items = 100000, .capacity = 64, .zero_copy = zero_copy});
+            for (int i = 0; i < 5; i++) // 1 to 16 producers and consumers
+                test_ring_multithread(&(TestParams){.mode = RING_MPMC, .num_producers = pow(2, i), .num_consumers = pow(2, i), .num_items = 10000, .capacity = 64, .zero_copy = zero_copy});
+        }
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
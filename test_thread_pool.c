@@ -0,0 +1,240 @@
+#include "thread_pool.h"
+#include "ws_deque.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <time.h>
+#include <math.h>
+#include "common_defs.h"
+#include "gitdata.h"
+
+#define POOL_SIZE (4 * 1024 * 1024)
+
+typedef struct
+{
+    WsDeque *deque;
+    int num_items;
+    atomic_int *taken;   // one flag per item, set by whoever got it
+    atomic_int *total;   // number of items taken so far
+} thread_data_t;
+
+typedef struct
+{
+    int num_thieves;
+    int num_items;
+} TestParams;
+
+// ********* Deque, single thread *********
+
+void test_ws_deque_basic(int count)
+{
+    printf_yellow("  Testing ws_deque push/pop/steal and growth (items: %d) ---> ", count);
+    mem_init(POOL_SIZE);
+
+    WsDeque *deque = ws_deque_create(4);
+    my_assert(deque != NULL);
+    my_assert(ws_deque_pop(deque) == NULL);
+    my_assert(ws_deque_steal(deque) == NULL);
+
+    // Grows from 4 slots; the owner sees LIFO order, thieves FIFO order
+    for (uintptr_t i = 1; i <= (uintptr_t)count; i++)
+        my_assert(ws_deque_push(deque, (void *)i) == 1);
+    my_assert(ws_deque_size(deque) == (size_t)count);
+    my_assert(ws_deque_steal(deque) == (void *)1);
+    my_assert(ws_deque_steal(deque) == (void *)2);
+    for (uintptr_t i = count; i > 2; i--)
+        my_assert(ws_deque_pop(deque) == (void *)i);
+    my_assert(ws_deque_pop(deque) == NULL);
+    my_assert(ws_deque_size(deque) == 0);
+
+    // Reuse after it has been emptied from both ends
+    my_assert(ws_deque_push(deque, (void *)7) == 1);
+    my_assert(ws_deque_steal(deque) == (void *)7);
+    my_assert(ws_deque_pop(deque) == NULL);
+
+    ws_deque_destroy(deque);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Deque, owner against thieves *********
+
+void *thread_thief(void *arg)
+{
+    thread_data_t *data = (thread_data_t *)arg;
+    while (atomic_load(data->total) < data->num_items)
+    {
+        uintptr_t item = (uintptr_t)ws_deque_steal(data->deque);
+        if (!item)
+        {
+            sched_yield();
+            continue;
+        }
+        my_assert(atomic_fetch_add(&data->taken[item - 1], 1) == 0);
+        atomic_fetch_add(data->total, 1);
+    }
+    return NULL;
+}
+
+// The owner pushes in bursts and pops some back while thieves steal; every
+// item must be taken exactly once
+void test_ws_deque_multithread(TestParams *params)
+{
+    printf_yellow("  Testing ws_deque with %d thieves (items: %d) ---> ", params->num_thieves, params->num_items);
+    mem_init(POOL_SIZE);
+
+    WsDeque *deque = ws_deque_create(16);
+    atomic_int *taken = calloc(params->num_items, sizeof(atomic_int));
+    atomic_int total = 0;
+    pthread_t threads[params->num_thieves];
+    thread_data_t data = {.deque = deque, .num_items = params->num_items, .taken = taken, .total = &total};
+
+    for (int i = 0; i < params->num_thieves; i++)
+        pthread_create(&threads[i], NULL, thread_thief, &data);
+
+    uintptr_t next = 1;
+    while (atomic_load(&total) < params->num_items)
+    {
+        for (int k = 0; k < 64 && next <= (uintptr_t)params->num_items; k++)
+            ws_deque_push(deque, (void *)next++);
+        for (int k = 0; k < 16; k++)
+        {
+            uintptr_t item = (uintptr_t)ws_deque_pop(deque);
+            if (!item)
+                break;
+            my_assert(atomic_fetch_add(&taken[item - 1], 1) == 0);
+            atomic_fetch_add(&total, 1);
+        }
+        sched_yield();
+    }
+    for (int i = 0; i < params->num_thieves; i++)
+        pthread_join(threads[i], NULL);
+
+    for (int i = 0; i < params->num_items; i++)
+        my_assert(atomic_load(&taken[i]) == 1);
+
+    free(taken);
+    ws_deque_destroy(deque);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Thread pool *********
+
+typedef struct
+{
+    ThreadPool *pool;
+    atomic_long *sum;
+    int depth;
+} SpawnArg;
+
+static void task_add(void *arg)
+{
+    SpawnArg *spawn = arg;
+    atomic_fetch_add(spawn->sum, 1);
+}
+
+// Each task spawns two children until depth runs out, so all work after the
+// first task is submitted from inside the pool and spread by stealing
+static void task_spawn(void *arg)
+{
+    SpawnArg *spawn = arg;
+    atomic_fetch_add(spawn->sum, 1);
+    if (spawn->depth == 0)
+    {
+        free(spawn);
+        return;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        SpawnArg *child = malloc(sizeof(SpawnArg));
+        *child = (SpawnArg){.pool = spawn->pool, .sum = spawn->sum, .depth = spawn->depth - 1};
+        my_assert(thread_pool_submit(spawn->pool, task_spawn, child) == 1);
+    }
+    free(spawn);
+}
+
+void test_thread_pool(int num_workers, int num_tasks, int depth)
+{
+    printf_yellow("  Testing thread pool (workers: %d, tasks: %d, spawn depth: %d) ---> ", num_workers, num_tasks, depth);
+    mem_init(POOL_SIZE);
+
+    ThreadPool *pool = thread_pool_create(num_workers);
+    my_assert(pool != NULL);
+    atomic_long sum = 0;
+
+    // Flat tasks from outside the pool
+    SpawnArg arg = {.pool = pool, .sum = &sum};
+    for (int i = 0; i < num_tasks; i++)
+        my_assert(thread_pool_submit(pool, task_add, &arg) == 1);
+    thread_pool_wait(pool);
+    my_assert(atomic_load(&sum) == num_tasks);
+
+    // Nested tasks: a binary tree of 2^(depth+1) - 1 tasks
+    atomic_store(&sum, 0);
+    SpawnArg *root = malloc(sizeof(SpawnArg));
+    *root = (SpawnArg){.pool = pool, .sum = &sum, .depth = depth};
+    thread_pool_submit(pool, task_spawn, root);
+    thread_pool_wait(pool);
+    my_assert(atomic_load(&sum) == (1L << (depth + 1)) - 1);
+
+    // The pool can be reused after a wait, destroy waits for what is left
+    atomic_store(&sum, 0);
+    for (int i = 0; i < num_tasks; i++)
+        thread_pool_submit(pool, task_add, &arg);
+    thread_pool_destroy(pool);
+    my_assert(atomic_load(&sum) == num_tasks);
+
+    // Everything went back to the pool
+    void *all = mem_alloc(POOL_SIZE / 2);
+    my_assert(all != NULL);
+    mem_free(all);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_ws_deque_basic - Owner and thief ends, growth\n");
+        printf(" 2. test_ws_deque_multithread - Owner against various numbers of thieves\n");
+        printf(" 3. test_thread_pool - Flat and nested tasks with various numbers of workers\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+    case 1:
+        test_ws_deque_basic(1000);
+        if (atoi(argv[1]) == 1)
+            break;
+        // fall through
+    case 2:
+        for (int i = 0; i < 4; i++) // 1 to 8 thieves
+            test_ws_deque_multithread(&(TestParams){.num_thieves = pow(2, i), .num_items = 100000});
+        if (atoi(argv[1]) == 2)
+            break;
+        // fall through
+    case 3:
+        for (int i = 0; i < 4; i++) // 1 to 8 workers
+            test_thread_pool(pow(2, i), 10000, 12);
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
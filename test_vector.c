@@ -0,0 +1,191 @@
+#include "vector.h"
+#include "linked_list.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include "common_defs.h"
+#include "gitdata.h"
+
+// ********* Basic operations *********
+
+void test_vector_basic(int count)
+{
+    printf_yellow("  Testing vec_push/pop/at/reserve (elements: %d) ---> ", count);
+    mem_init(count * 16 + 64 * 1024);
+
+    Vector *vec = vec_create(sizeof(uint32_t), 0);
+    my_assert(vec != NULL);
+    my_assert(vec_size(vec) == 0);
+    my_assert(vec_at(vec, 0) == NULL);
+    my_assert(vec_pop(vec, NULL) == 0);
+
+    for (uint32_t i = 0; i < (uint32_t)count; i++)
+        my_assert(vec_push(vec, &i) == 1);
+    my_assert(vec_size(vec) == (size_t)count);
+    my_assert(vec_capacity(vec) >= (size_t)count);
+    for (int i = 0; i < count; i++)
+        my_assert(*(uint32_t *)vec_at(vec, i) == (uint32_t)i);
+    my_assert(((uint32_t *)vec_data(vec))[count - 1] == (uint32_t)(count - 1));
+    my_assert(vec_at(vec, count) == NULL);
+
+    uint32_t value = 0;
+    my_assert(vec_pop(vec, &value) == 1 && value == (uint32_t)(count - 1));
+    my_assert(vec_size(vec) == (size_t)(count - 1));
+
+    // reserve never shrinks, clear keeps the storage
+    size_t capacity = vec_capacity(vec);
+    my_assert(vec_reserve(vec, 1) == 1 && vec_capacity(vec) == capacity);
+    my_assert(vec_reserve(vec, capacity * 2) == 1 && vec_capacity(vec) == capacity * 2);
+    my_assert(*(uint32_t *)vec_at(vec, count - 2) == (uint32_t)(count - 2));
+    vec_clear(vec);
+    my_assert(vec_size(vec) == 0 && vec_capacity(vec) == capacity * 2);
+
+    // Growing past the pool fails without losing the contents
+    vec_push(vec, &value);
+    my_assert(vec_reserve(vec, count * 64) == 0);
+    my_assert(vec_size(vec) == 1 && *(uint32_t *)vec_at(vec, 0) == value);
+
+    // A count whose byte size overflows fails and leaves the vector usable
+    capacity = vec_capacity(vec);
+    my_assert(vec_reserve(vec, (size_t)1 << 62) == 0);
+    my_assert(vec_reserve(vec, SIZE_MAX / 2) == 0);
+    my_assert(vec_capacity(vec) == capacity);
+    my_assert(vec_push(vec, &value) == 1 && vec_size(vec) == 2);
+    my_assert(*(uint32_t *)vec_at(vec, 1) == value);
+    my_assert(vec_create(sizeof(uint32_t), (size_t)1 << 62) == NULL);
+
+    vec_destroy(vec);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Growth in place *********
+
+void test_vector_growth(int count)
+{
+    printf_yellow("  Testing in-place growth with mem_resize (elements: %d) ---> ", count);
+    mem_init(count * 16 + 64 * 1024);
+    VectorStats stats;
+
+    // Alone in the pool every growth step can take over the free block behind it
+    Vector *vec = vec_create(sizeof(uint32_t), 0);
+    for (uint32_t i = 0; i < (uint32_t)count; i++)
+        vec_push(vec, &i);
+    vec_get_stats(vec, &stats);
+    my_assert(stats.grows > 0);
+    my_assert(stats.in_place == stats.grows);
+    my_assert(stats.moved == 0 && stats.bytes_copied == 0);
+    vec_destroy(vec);
+
+    // A block allocated right behind the storage forces the next step to move
+    vec = vec_create(sizeof(uint32_t), 0);
+    void *blocker = mem_alloc(8);
+    for (uint32_t i = 0; i < (uint32_t)count; i++)
+        vec_push(vec, &i);
+    vec_get_stats(vec, &stats);
+    my_assert(stats.moved == 1);
+    my_assert(stats.in_place == stats.grows - 1);
+    my_assert(stats.bytes_copied == 8 * sizeof(uint32_t));
+    for (int i = 0; i < count; i++)
+        my_assert(*(uint32_t *)vec_at(vec, i) == (uint32_t)i);
+
+    mem_free(blocker);
+    vec_destroy(vec);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// ********* Benchmark *********
+
+double elapsed_ms(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Times full scans of the same values in a vector and in a linked list
+void bench_vector_vs_list(int count, int rounds)
+{
+    printf_yellow("  Benchmarking scans (elements: %d, rounds: %d) ---> ", count, rounds);
+    Node *head = NULL;
+    mem_init(count * 64 + 64 * 1024);
+    list_init(&head, 0); // pool is already initialized above
+    Vector *vec = vec_create(sizeof(uint16_t), 0);
+
+    for (int i = 0; i < count; i++)
+    {
+        uint16_t value = i;
+        vec_push(vec, &value);
+        list_insert(&head, value);
+    }
+
+    struct timespec start, end;
+    unsigned long vec_sum = 0, list_sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < rounds; r++)
+    {
+        const uint16_t *data = vec_data(vec);
+        for (size_t i = 0; i < vec_size(vec); i++)
+            vec_sum += data[i];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double vec_ms = elapsed_ms(&start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < rounds; r++)
+        for (Node *node = head; node; node = node->next)
+            list_sum += node->data;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double list_ms = elapsed_ms(&start, &end);
+    my_assert(vec_sum == list_sum);
+
+    VectorStats stats;
+    vec_get_stats(vec, &stats);
+    vec_destroy(vec);
+    list_cleanup(&head);
+    printf_green("[DONE].\n");
+    printf("\tvector: %.3f ms, list: %.3f ms per scan; growth %lu in place, %lu moved\n",
+           vec_ms / rounds, list_ms / rounds, stats.in_place, stats.moved);
+}
+
+// Main function to run all tests
+int main(int argc, char *argv[])
+{
+#ifdef VERSION
+    printf("Build Version; %s \n", VERSION);
+#endif
+    printf("Git Version; %s/%s \n", git_date, git_sha);
+    if (argc < 2)
+    {
+        printf("Usage: %s <test function>\n", argv[0]);
+        printf("Available test functions:\n");
+        printf(" 1. test_vector_basic - Push, pop, indexing and reserve\n");
+        printf(" 2. test_vector_growth - Count in-place and moving growth steps\n");
+        printf(" 3. bench_vector_vs_list [elements] - Compare scans with a linked list\n");
+        printf(" 0. Run all tests\n");
+        return 1;
+    }
+
+    switch (atoi(argv[1]))
+    {
+    case 0:
+        test_vector_basic(10000);
+        test_vector_growth(10000);
+        break;
+    case 1:
+        test_vector_basic(10000);
+        break;
+    case 2:
+        test_vector_growth(10000);
+        break;
+    case 3:
+        bench_vector_vs_list(argc > 2 ? atoi(argv[2]) : 16384, 100);
+        break;
+    default:
+        printf("Invalid test function\n");
+        break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include "thread_pool.h"
+#include "ws_deque.h"
+#include "lf_queue.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+/*
+ * Trådpool ovanpå work-stealing-dequerna:
+ * - en arbetare tar först från sin egen deque (LIFO, varm cache), sedan
+ *   från inkön och sist stjäl den från en slumpvis vald granne (FIFO)
+ * - ingen kö har ett gemensamt lås; mutexarna nedan används bara för att
+ *   söva och väcka lediga arbetare och för thread_pool_wait
+ * - uppgiftsposter återanvänds via en lista per arbetare, så en uppgift
+ *   som köas inifrån en annan kostar normalt ingen mem_alloc
+ */
+
+#define POOL_DEQUE_CAPACITY 256
+#define POOL_SPIN_ROUNDS    64    // varv utan arbete innan arbetaren somnar
+#define POOL_FREE_MAX       256   // sparade uppgiftsposter per arbetare
+
+typedef struct PoolTask {
+    pool_task_fn     fn;
+    void            *arg;
+    struct PoolTask *next;   // i arbetarens lista med lediga poster
+} PoolTask;
+
+typedef struct {
+    ThreadPool *pool;
+    WsDeque    *deque;
+    pthread_t   thread;
+    PoolTask   *free_tasks;
+    size_t      num_free;
+    unsigned    seed;        // för val av offer
+} PoolWorker;
+
+struct ThreadPool {
+    PoolWorker      *workers;
+    int              num_workers;
+    LfQueue         *inbox;        // uppgifter från trådar utanför poolen
+    atomic_long      queued;       // köade men inte påbörjade
+    atomic_long      unfinished;   // köade men inte avslutade
+    atomic_int       sleepers;
+    atomic_int       stop;
+    pthread_mutex_t  idle_lock;
+    pthread_cond_t   idle_cond;
+    pthread_mutex_t  done_lock;
+    pthread_cond_t   done_cond;
+};
+
+// Arbetaren som kör på den här tråden, NULL utanför poolerna
+static __thread PoolWorker *current_worker;
+
+static PoolTask *task_get(PoolWorker *self) {
+    if (self && self->free_tasks) {
+        PoolTask *task = self->free_tasks;
+        self->free_tasks = task->next;
+        self->num_free--;
+        return task;
+    }
+    return mem_alloc(sizeof(PoolTask));
+}
+
+static void task_put(PoolWorker *self, PoolTask *task) {
+    if (self->num_free < POOL_FREE_MAX) {
+        task->next = self->free_tasks;
+        self->free_tasks = task;
+        self->num_free++;
+    } else {
+        mem_free(task);
+    }
+}
+
+static PoolTask *find_task(PoolWorker *self) {
+    ThreadPool *pool = self->pool;
+
+    PoolTask *task = ws_deque_pop(self->deque);
+    if (task) return task;
+
+    void *value;
+    if (lf_queue_dequeue(pool->inbox, &value) == 1) return value;
+
+    int start = rand_r(&self->seed) % pool->num_workers;
+    for (int i = 0; i < pool->num_workers; i++) {
+        PoolWorker *victim = &pool->workers[(start + i) % pool->num_workers];
+        if (victim == self) continue;
+        task = ws_deque_steal(victim->deque);
+        if (task) return task;
+    }
+    return NULL;
+}
+
+// Sover tills något köas. sleepers räknas upp före kontrollen av queued
+// och submit läser sleepers efter att ha räknat upp queued, så minst en
+// av dem ser den andra och väckningen kan inte tappas
+static void wait_for_work(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->idle_lock);
+    atomic_fetch_add(&pool->sleepers, 1);
+    while (atomic_load(&pool->queued) <= 0 && !atomic_load(&pool->stop))
+        pthread_cond_wait(&pool->idle_cond, &pool->idle_lock);
+    atomic_fetch_sub(&pool->sleepers, 1);
+    pthread_mutex_unlock(&pool->idle_lock);
+}
+
+static void *worker_main(void *arg) {
+    PoolWorker *self = arg;
+    ThreadPool *pool = self->pool;
+    current_worker = self;
+    int idle = 0;
+
+    while (!atomic_load(&pool->stop)) {
+        PoolTask *task = find_task(self);
+        if (!task) {
+            if (++idle < POOL_SPIN_ROUNDS) {
+                sched_yield();
+            } else {
+                wait_for_work(pool);
+                idle = 0;
+            }
+            continue;
+        }
+        idle = 0;
+        atomic_fetch_sub(&pool->queued, 1);
+        task->fn(task->arg);
+        task_put(self, task);
+
+        if (atomic_fetch_sub(&pool->unfinished, 1) == 1) {
+            pthread_mutex_lock(&pool->done_lock);
+            pthread_cond_broadcast(&pool->done_cond);
+            pthread_mutex_unlock(&pool->done_lock);
+        }
+    }
+    current_worker = NULL;
+    return NULL;
+}
+
+ThreadPool *thread_pool_create(int num_workers) {
+    if (num_workers < 1) num_workers = 1;
+
+    ThreadPool *pool = mem_alloc(sizeof(ThreadPool));
+    if (!pool) return NULL;
+    pool->workers = mem_alloc(num_workers * sizeof(PoolWorker));
+    pool->inbox = lf_queue_create();
+    if (!pool->workers || !pool->inbox) goto fail;
+
+    pool->num_workers = num_workers;
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->unfinished, 0);
+    atomic_init(&pool->sleepers, 0);
+    atomic_init(&pool->stop, 0);
+    pthread_mutex_init(&pool->idle_lock, NULL);
+    pthread_cond_init(&pool->idle_cond, NULL);
+    pthread_mutex_init(&pool->done_lock, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    for (int i = 0; i < num_workers; i++) {
+        PoolWorker *w = &pool->workers[i];
+        w->pool       = pool;
+        w->free_tasks = NULL;
+        w->num_free   = 0;
+        w->seed       = i + 1;
+        w->deque      = ws_deque_create(POOL_DEQUE_CAPACITY);
+        if (!w->deque) {
+            while (i--) ws_deque_destroy(pool->workers[i].deque);
+            goto fail;
+        }
+    }
+    for (int i = 0; i < num_workers; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+            // de som hann starta stoppas; inget arbete har lämnats in än
+            pthread_mutex_lock(&pool->idle_lock);
+            atomic_store(&pool->stop, 1);
+            pthread_cond_broadcast(&pool->idle_cond);
+            pthread_mutex_unlock(&pool->idle_lock);
+            for (int j = 0; j < i; j++)
+                pthread_join(pool->workers[j].thread, NULL);
+            for (int j = 0; j < num_workers; j++)
+                ws_deque_destroy(pool->workers[j].deque);
+            pthread_mutex_destroy(&pool->idle_lock);
+            pthread_cond_destroy(&pool->idle_cond);
+            pthread_mutex_destroy(&pool->done_lock);
+            pthread_cond_destroy(&pool->done_cond);
+            goto fail;
+        }
+    }
+    return pool;
+
+fail:
+    if (pool->inbox) lf_queue_destroy(pool->inbox);
+    mem_free(pool->workers);
+    mem_free(pool);
+    return NULL;
+}
+
+int thread_pool_submit(ThreadPool *pool, pool_task_fn fn, void *arg) {
+    PoolWorker *self = current_worker && current_worker->pool == pool ? current_worker : NULL;
+    PoolTask *task = task_get(self);
+    if (!task) return 0;
+    task->fn  = fn;
+    task->arg = arg;
+
+    atomic_fetch_add(&pool->unfinished, 1);
+    atomic_fetch_add(&pool->queued, 1);
+    int ok = self ? ws_deque_push(self->deque, task)
+                  : lf_queue_enqueue(pool->inbox, task) == 0;
+    if (!ok) {
+        atomic_fetch_sub(&pool->queued, 1);
+        atomic_fetch_sub(&pool->unfinished, 1);
+        mem_free(task);
+        return 0;
+    }
+
+    if (atomic_load(&pool->sleepers) > 0) {
+        pthread_mutex_lock(&pool->idle_lock);
+        pthread_cond_signal(&pool->idle_cond);
+        pthread_mutex_unlock(&pool->idle_lock);
+    }
+    return 1;
+}
+
+void thread_pool_wait(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->done_lock);
+    while (atomic_load(&pool->unfinished) > 0)
+        pthread_cond_wait(&pool->done_cond, &pool->done_lock);
+    pthread_mutex_unlock(&pool->done_lock);
+}
+
+void thread_pool_destroy(ThreadPool *pool) {
+    if (!pool) return;
+    thread_pool_wait(pool);
+
+    pthread_mutex_lock(&pool->idle_lock);
+    atomic_store(&pool->stop, 1);
+    pthread_cond_broadcast(&pool->idle_cond);
+    pthread_mutex_unlock(&pool->idle_lock);
+
+    for (int i = 0; i < pool->num_workers; i++) {
+        PoolWorker *w = &pool->workers[i];
+        pthread_join(w->thread, NULL);
+        while (w->free_tasks) {
+            PoolTask *next = w->free_tasks->next;
+            mem_free(w->free_tasks);
+            w->free_tasks = next;
+        }
+        ws_deque_destroy(w->deque);
+    }
+    lf_queue_destroy(pool->inbox);
+    pthread_mutex_destroy(&pool->idle_lock);
+    pthread_cond_destroy(&pool->idle_cond);
+    pthread_mutex_destroy(&pool->done_lock);
+    pthread_cond_destroy(&pool->done_cond);
+    mem_free(pool->workers);
+    mem_free(pool);
+}
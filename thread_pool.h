@@ -0,0 +1,28 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "memory_manager.h"
+
+// Trådpool med en work-stealing-deque per arbetare. En uppgift som läggs
+// till inifrån en uppgift hamnar i arbetarens egen deque; lediga arbetare
+// stjäl från de andra. Uppgifter utifrån går via en lås-fri kö.
+// Allt minne tas från minneshanteraren (mem_init först)
+typedef struct ThreadPool ThreadPool;
+
+typedef void (*pool_task_fn)(void* arg);
+
+// Startar num_workers arbetare. NULL om minnet inte räcker eller en
+// arbetstråd inte kan startas
+ThreadPool* thread_pool_create(int num_workers);
+
+// Köar fn(arg). Returnerar 1, eller 0 om minnet tog slut
+int thread_pool_submit(ThreadPool* pool, pool_task_fn fn, void* arg);
+
+// Väntar tills alla köade uppgifter, även de de i sin tur köat, är klara.
+// Får inte anropas inifrån en uppgift
+void thread_pool_wait(ThreadPool* pool);
+
+// Väntar in alla uppgifter, stoppar arbetarna och frigör poolen
+void thread_pool_destroy(ThreadPool* pool);
+
+#endif
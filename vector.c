@@ -0,0 +1,110 @@
+#include "vector.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Vektor ovanpå minneshanteraren:
+ * - huvudet allokeras före lagringen, så lagringen hamnar efter det i
+ *   poolen och har störst chans att ha ett fritt block bakom sig
+ * - kapaciteten dubblas; mem_resize växer på plats in i nästa fria block
+ *   och kopierar bara när det inte går. Adressen avgör vilket som hände
+ */
+
+#define VEC_MIN_CAPACITY 8
+
+struct Vector {
+    unsigned char *data;
+    size_t         size;
+    size_t         capacity;
+    size_t         elem_size;
+    VectorStats    stats;
+};
+
+static int grow_to(Vector *vec, size_t capacity) {
+    if (capacity <= vec->capacity) return 1;
+    if (capacity > SIZE_MAX / vec->elem_size) return 0;   // byte räknas inte utan overflow
+
+    unsigned char *data = mem_resize(vec->data, capacity * vec->elem_size);
+    if (!data) return 0;   // gamla lagringen är orörd
+
+    vec->stats.grows++;
+    if (data == vec->data) {
+        vec->stats.in_place++;
+    } else {
+        vec->stats.moved++;
+        vec->stats.bytes_copied += vec->capacity * vec->elem_size;
+    }
+    vec->data     = data;
+    vec->capacity = capacity;
+    return 1;
+}
+
+Vector *vec_create(size_t elem_size, size_t capacity) {
+    if (elem_size == 0) return NULL;
+    if (capacity > SIZE_MAX / elem_size) return NULL;
+
+    Vector *vec = mem_alloc(sizeof(Vector));
+    if (!vec) return NULL;
+    memset(vec, 0, sizeof(Vector));
+    vec->elem_size = elem_size;
+
+    if (capacity < VEC_MIN_CAPACITY) capacity = VEC_MIN_CAPACITY;
+    vec->data = mem_alloc(capacity * elem_size);
+    if (!vec->data) {
+        mem_free(vec);
+        return NULL;
+    }
+    vec->capacity = capacity;
+    return vec;
+}
+
+void vec_destroy(Vector *vec) {
+    if (!vec) return;
+    mem_free(vec->data);
+    mem_free(vec);
+}
+
+int vec_push(Vector *vec, const void *elem) {
+    if (vec->size == vec->capacity && !grow_to(vec, vec->capacity * 2))
+        return 0;
+    memcpy(vec->data + vec->size * vec->elem_size, elem, vec->elem_size);
+    vec->size++;
+    return 1;
+}
+
+int vec_pop(Vector *vec, void *elem) {
+    if (vec->size == 0) return 0;
+    vec->size--;
+    if (elem) memcpy(elem, vec->data + vec->size * vec->elem_size, vec->elem_size);
+    return 1;
+}
+
+void *vec_at(Vector *vec, size_t index) {
+    if (index >= vec->size) return NULL;
+    return vec->data + index * vec->elem_size;
+}
+
+void *vec_data(Vector *vec) {
+    return vec->data;
+}
+
+int vec_reserve(Vector *vec, size_t capacity) {
+    return grow_to(vec, capacity);
+}
+
+void vec_clear(Vector *vec) {
+    vec->size = 0;
+}
+
+size_t vec_size(Vector *vec) {
+    return vec->size;
+}
+
+size_t vec_capacity(Vector *vec) {
+    return vec->capacity;
+}
+
+void vec_get_stats(Vector *vec, VectorStats *stats) {
+    *stats = vec->stats;
+}
@@ -0,0 +1,53 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+
+#include <stddef.h>   // för size_t
+#include "memory_manager.h"
+
+// Dynamisk array med element av fast storlek. Lagringen är ett enda
+// mem_alloc-block som växer geometriskt med mem_resize, så blocket växer
+// på plats när nästa block i poolen är fritt (mem_init först).
+// Inte trådsäker, ägaren serialiserar själv som för en vanlig array
+typedef struct Vector Vector;
+
+typedef struct {
+    unsigned long grows;          // antal gånger lagringen växte
+    unsigned long in_place;       // ... varav på plats utan kopiering
+    unsigned long moved;          // ... varav flyttade till ett nytt block
+    unsigned long bytes_copied;   // byte som kopierades vid flyttarna
+} VectorStats;
+
+// Skapar en tom vektor med plats för capacity element om elem_size byte.
+// NULL om minnet inte räcker eller storleken i byte inte ryms i size_t
+Vector* vec_create(size_t elem_size, size_t capacity);
+
+// Frigör vektorn och lagringen
+void vec_destroy(Vector* vec);
+
+// Lägger till ett element sist. Returnerar 1, eller 0 om minnet inte räcker
+int vec_push(Vector* vec, const void* elem);
+
+// Tar bort sista elementet och kopierar ut det om elem inte är NULL.
+// Returnerar 1, eller 0 om vektorn är tom
+int vec_pop(Vector* vec, void* elem);
+
+// Pekare till element index, NULL utanför storleken
+void* vec_at(Vector* vec, size_t index);
+
+// Pekare till första elementet; giltig tills vektorn växer
+void* vec_data(Vector* vec);
+
+// Ser till att det finns plats för minst capacity element. Returnerar 1,
+// eller 0 om minnet inte räcker eller capacity * elem_size inte ryms i size_t
+int vec_reserve(Vector* vec, size_t capacity);
+
+// Tömmer vektorn men behåller lagringen
+void vec_clear(Vector* vec);
+
+size_t vec_size(Vector* vec);
+size_t vec_capacity(Vector* vec);
+
+// Hur ofta lagringen växte på plats respektive flyttades
+void vec_get_stats(Vector* vec, VectorStats* stats);
+
+#endif
@@ -0,0 +1,132 @@
+#include "ws_deque.h"
+
+#include <stdatomic.h>
+
+/*
+ * Chase-Lev-deque med minnesordningarna från Lê m.fl. (PPoPP 2013):
+ * - bottom ändras bara av ägaren, top flyttas med CAS av tjuvar och av
+ *   ägaren när båda slåss om det sista elementet
+ * - när arrayen är full kopieras den till en dubbelt så stor. En tjuv
+ *   kan fortfarande läsa den gamla, så den länkas in bakom den nya och
+ *   frigörs först i ws_deque_destroy (högst lika mycket som den nya)
+ */
+
+typedef struct WsArray {
+    struct WsArray *prev;   // föregående, mindre array
+    size_t          mask;   // antal platser - 1
+    _Atomic(void *) slots[];
+} WsArray;
+
+struct WsDeque {
+    atomic_long        top;
+    char               pad0[64 - sizeof(atomic_long)];   // top och bottom på olika cacherader
+    atomic_long        bottom;
+    _Atomic(WsArray *) array;
+};
+
+static WsArray *array_create(size_t capacity) {
+    WsArray *a = mem_alloc(sizeof(WsArray) + capacity * sizeof(void *));
+    if (!a) return NULL;
+    a->prev = NULL;
+    a->mask = capacity - 1;
+    return a;
+}
+
+// Kopierar elementen top..bottom till en dubbelt så stor array
+static WsArray *array_grow(WsArray *a, long bottom, long top) {
+    WsArray *bigger = array_create((a->mask + 1) * 2);
+    if (!bigger) return NULL;
+    for (long i = top; i < bottom; i++) {
+        void *item = atomic_load_explicit(&a->slots[i & a->mask], memory_order_relaxed);
+        atomic_store_explicit(&bigger->slots[i & bigger->mask], item, memory_order_relaxed);
+    }
+    bigger->prev = a;
+    return bigger;
+}
+
+WsDeque *ws_deque_create(size_t capacity) {
+    size_t n = 2;
+    while (n < capacity) n <<= 1;
+
+    WsDeque *deque = mem_alloc(sizeof(WsDeque));
+    if (!deque) return NULL;
+    WsArray *a = array_create(n);
+    if (!a) {
+        mem_free(deque);
+        return NULL;
+    }
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, a);
+    return deque;
+}
+
+void ws_deque_destroy(WsDeque *deque) {
+    if (!deque) return;
+    WsArray *a = atomic_load(&deque->array);
+    while (a) {
+        WsArray *prev = a->prev;
+        mem_free(a);
+        a = prev;
+    }
+    mem_free(deque);
+}
+
+int ws_deque_push(WsDeque *deque, void *item) {
+    long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    WsArray *a = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    if (b - t > (long)a->mask) {
+        a = array_grow(a, b, t);
+        if (!a) return 0;
+        atomic_store_explicit(&deque->array, a, memory_order_release);
+    }
+    atomic_store_explicit(&a->slots[b & a->mask], item, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    return 1;
+}
+
+void *ws_deque_pop(WsDeque *deque) {
+    long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    WsArray *a = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (t > b) {
+        // tom
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+    void *item = atomic_load_explicit(&a->slots[b & a->mask], memory_order_relaxed);
+    if (t == b) {
+        // sista elementet: tävla med tjuvarna om top
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed))
+            item = NULL;
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+void *ws_deque_steal(WsDeque *deque) {
+    long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+
+    WsArray *a = atomic_load_explicit(&deque->array, memory_order_acquire);
+    void *item = atomic_load_explicit(&a->slots[t & a->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed))
+        return NULL;
+    return item;
+}
+
+size_t ws_deque_size(WsDeque *deque) {
+    long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    return b > t ? (size_t)(b - t) : 0;
+}
@@ -0,0 +1,32 @@
+#ifndef WS_DEQUE_H
+#define WS_DEQUE_H
+
+#include <stddef.h>   // för size_t
+#include "memory_manager.h"
+
+// Chase-Lev-deque för work stealing. Ägartråden lägger till och tar i
+// ena änden utan lås; andra trådar stjäl från den andra änden med en CAS.
+// Lagringen tas från minneshanteraren (mem_init först) och växer vid behov
+typedef struct WsDeque WsDeque;
+
+// Skapar en tom deque med plats för capacity element innan den växer
+// (avrundas uppåt till en tvåpotens). NULL om minnet inte räcker
+WsDeque* ws_deque_create(size_t capacity);
+
+// Frigör dequen. Ingen tråd får använda den samtidigt
+void ws_deque_destroy(WsDeque* deque);
+
+// Endast ägaren: lägger item sist. Returnerar 1, eller 0 om minnet tog slut
+int ws_deque_push(WsDeque* deque, void* item);
+
+// Endast ägaren: tar senast inlagda elementet, NULL om dequen är tom
+void* ws_deque_pop(WsDeque* deque);
+
+// Valfri tråd: tar äldsta elementet, NULL om dequen är tom eller om en
+// annan tråd hann före (försök igen eller välj en annan deque)
+void* ws_deque_steal(WsDeque* deque);
+
+// Ungefärligt antal element
+size_t ws_deque_size(WsDeque* deque);
+
+#endif